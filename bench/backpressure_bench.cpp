@@ -0,0 +1,52 @@
+#include "lib/CCircularBuffer.h"
+#include "bench/bench_util.h"
+
+#include <string>
+
+// Cost of rejecting a push into a full buffer and a pop from an empty one.
+
+template<typename T>
+void run(const std::string& type, const T& value, size_t iterations) {
+    const size_t kcapacity = 1024;
+    CCircularBuffer<T> full(kcapacity);
+    while (full.size() < full.capacity()) {
+        full.push_back(value);
+    }
+    CCircularBuffer<T> empty(kcapacity);
+
+#if defined(__cpp_exceptions)
+    print_result(type + " push_back (throws) at 100% fill", measure_ns(iterations, [&] {
+        try {
+            full.push_back(value);
+        } catch (const FullBufferException&) {
+            do_not_optimize(full);
+        }
+    }));
+    print_result(type + " pop_front (throws) when empty", measure_ns(iterations, [&] {
+        try {
+            empty.pop_front();
+        } catch (const EmptyBufferException&) {
+            do_not_optimize(empty);
+        }
+    }));
+#endif
+    print_result(type + " try_push_back at 100% fill", measure_ns(iterations, [&] {
+        bool pushed = full.try_push_back(value);
+        do_not_optimize(pushed);
+    }));
+    print_result(type + " try_emplace_back at 100% fill", measure_ns(iterations, [&] {
+        bool pushed = full.try_emplace_back(value);
+        do_not_optimize(pushed);
+    }));
+    print_result(type + " try_pop_front when empty", measure_ns(iterations, [&] {
+        auto popped = empty.try_pop_front();
+        do_not_optimize(popped);
+    }));
+}
+
+int main() {
+    const size_t kiterations = 1'000'000;
+    run<int>("int", 42, kiterations);
+    run<std::string>("string", std::string(64, 'x'), kiterations);
+    return 0;
+}
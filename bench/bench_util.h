@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs f() iterations times and returns the mean time of one call in nanoseconds.
+template<typename F>
+double measure_ns(size_t iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        f();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / static_cast<double>(iterations);
+}
+
+inline void print_result(const std::string& name, double ns_per_op) {
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(12)
+              << std::fixed << std::setprecision(2) << ns_per_op << " ns/op\n";
+}
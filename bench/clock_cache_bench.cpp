@@ -0,0 +1,91 @@
+#include "lib/CClockCache.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Hit rate and throughput of CClockCache against std::list + std::unordered_map LRU on Zipfian traces.
+
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity) {}
+
+    uint64_t* find(uint64_t key) {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            return nullptr;
+        }
+        order_.splice(order_.begin(), order_, it->second);
+        return &it->second->second;
+    }
+
+    void put(uint64_t key, uint64_t value) {
+        if (order_.size() == capacity_) {
+            map_.erase(order_.back().first);
+            order_.pop_back();
+        }
+        order_.emplace_front(key, value);
+        map_[key] = order_.begin();
+    }
+
+private:
+    size_t capacity_;
+    std::list<std::pair<uint64_t, uint64_t>> order_;
+    std::unordered_map<uint64_t, std::list<std::pair<uint64_t, uint64_t>>::iterator> map_;
+};
+
+std::vector<uint64_t> zipf_trace(size_t keys, double s, size_t length, uint64_t seed) {
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (size_t i = 0; i < keys; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+        cdf[i] = sum;
+    }
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<uint64_t> trace(length);
+    for (auto& key: trace) {
+        key = std::lower_bound(cdf.begin(), cdf.end(), uniform(random)) - cdf.begin();
+        key = key * 0x9E3779B97F4A7C15ull; // scatter popular keys over the key space
+    }
+    return trace;
+}
+
+template<typename Cache>
+void run(const std::string& name, Cache& cache, const std::vector<uint64_t>& trace) {
+    size_t hits = 0;
+    auto it = trace.begin();
+    double ns = measure_ns(trace.size(), [&] {
+        uint64_t key = *it++;
+        if (uint64_t* value = cache.find(key)) {
+            do_not_optimize(*value);
+            ++hits;
+        } else {
+            cache.put(key, key);
+        }
+    });
+    print_result(name, ns);
+    std::cout << "    hit rate: " << std::setprecision(4) << 100.0 * hits / trace.size() << "%\n";
+}
+
+int main() {
+    const size_t kkeys = 1'000'000;
+    const size_t klength = 5'000'000;
+    for (double s: {0.8, 0.99, 1.2}) {
+        auto trace = zipf_trace(kkeys, s, klength, 42);
+        for (size_t capacity: {1'000, 10'000, 100'000}) {
+            std::string suffix = " s=" + std::to_string(s).substr(0, 4) + " capacity=" + std::to_string(capacity);
+            CClockCache<uint64_t, uint64_t> clock(capacity);
+            run("clock" + suffix, clock, trace);
+            LruCache lru(capacity);
+            run("lru  " + suffix, lru, trace);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CDedupWindow.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rejecting message ids seen in the last N messages: linear scan over a CCircularBuffer<uint64_t>
+// against CDedupWindow. About a quarter of the ids are repeats.
+
+constexpr size_t kiterations = 200'000;
+
+int main() {
+    for (size_t window: {64, 1024, 16384}) {
+        std::vector<uint64_t> ids(kiterations);
+        std::mt19937_64 rng(8);
+        for (size_t i = 0; i < ids.size(); ++i) {
+            ids[i] = i > 0 && rng() % 4 == 0 ? ids[i - 1 - rng() % std::min(i, window)] : rng();
+        }
+        std::string suffix = " window=" + std::to_string(window);
+
+        {
+            CCircularBuffer<uint64_t> ring(window);
+            size_t i = 0;
+            print_result("linear scan" + suffix, measure_ns(kiterations, [&] {
+                uint64_t id = ids[i++];
+                if (std::find(ring.begin(), ring.end(), id) == ring.end()) {
+                    if (ring.size() == ring.capacity()) {
+                        ring.pop_front();
+                    }
+                    ring.push_back(id);
+                }
+            }));
+        }
+        {
+            CDedupWindow<uint64_t> dedup(window);
+            size_t i = 0;
+            print_result("CDedupWindow" + suffix, measure_ns(kiterations, [&] {
+                do_not_optimize(dedup.insert_if_absent(ids[i++]));
+            }));
+        }
+    }
+    return 0;
+}
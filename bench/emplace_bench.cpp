@@ -0,0 +1,70 @@
+#include "lib/CCircularBufferExt.h"
+#include "bench/bench_util.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Throughput of in-place construction with a copy counting message type.
+
+constexpr size_t klength = 64;
+
+struct Message {
+    static inline size_t copies = 0;
+
+    Message(int id, size_t length) : id(id), payload(length, 'x'), tags{1, 2, 3} {}
+
+    Message(const Message& other) : id(other.id), payload(other.payload), tags(other.tags) { ++copies; }
+
+    Message(Message&& other) noexcept = default;
+
+    Message& operator=(const Message& other) {
+        id = other.id;
+        payload = other.payload;
+        tags = other.tags;
+        ++copies;
+        return *this;
+    }
+
+    Message& operator=(Message&& other) noexcept = default;
+
+    int id;
+    std::string payload;
+    std::vector<int> tags;
+};
+
+template<typename Buffer, typename F>
+void run(const std::string& name, size_t iterations, F&& push) {
+    const size_t kcapacity = 1024;
+    Buffer buffer(kcapacity);
+    Message::copies = 0;
+    double ns = measure_ns(iterations, [&] {
+        if (buffer.size() == kcapacity) {
+            buffer.clear();
+        }
+        push(buffer);
+    });
+    print_result(name, ns);
+    std::cout << "    copies: " << Message::copies << '\n';
+}
+
+int main() {
+    const size_t kiterations = 1'000'000;
+
+    run<CCircularBuffer<Message>>("emplace_back", kiterations, [](auto& b) {
+        b.emplace_back(1, klength);
+    });
+    run<CCircularBuffer<Message>>("push_back(Message&&)", kiterations, [](auto& b) {
+        b.push_back(Message(1, klength));
+    });
+    run<CCircularBuffer<Message>>("emplace_front", kiterations, [](auto& b) {
+        b.emplace_front(1, klength);
+    });
+    run<CCircularBufferExt<Message>>("CCircularBufferExt push_back(Message&&)", kiterations, [](auto& b) {
+        b.push_back(Message(1, klength));
+    });
+    run<CCircularBuffer<Message>>("emplace in the middle", kiterations / 100, [](auto& b) {
+        b.emplace(b.cbegin() + b.size() / 2, 1, klength);
+    });
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "lib/CFlightRecorder.h"
+#include "bench/bench_util.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// Cost of CFlightRecorder::record() with 1..8 threads appending concurrently, and of a full dump.
+
+constexpr size_t kiterations = 2'000'000;
+
+int main() {
+    CFlightRecorder recorder(1 << 16);
+
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+        std::vector<double> results(threads);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&recorder, &results, t] {
+                uint64_t i = 0;
+                results[t] = measure_ns(kiterations, [&] { recorder.record(1, i++, t); });
+            });
+        }
+        double total = 0;
+        for (size_t t = 0; t < threads; ++t) {
+            workers[t].join();
+            total += results[t];
+        }
+        print_result("record threads=" + std::to_string(threads), total / static_cast<double>(threads));
+    }
+
+    int fd = open("/dev/null", O_WRONLY);
+    double ns = measure_ns(20, [&] { recorder.dump(fd); });
+    close(fd);
+    print_result("dump " + std::to_string(recorder.threads()) + " threads to /dev/null", ns);
+    return 0;
+}
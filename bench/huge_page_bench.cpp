@@ -0,0 +1,46 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CHugePageAllocator.h"
+#include "bench/bench_util.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Startup (allocate and fill) and random operator[] time of a large CCircularBuffer
+// with std::allocator and CHugePageAllocator.
+// Usage: huge_page_bench [megabytes]
+
+template<typename Alloc>
+void run(const std::string& name, size_t elements, size_t lookups) {
+    auto start = std::chrono::steady_clock::now();
+    CCircularBuffer<uint64_t, Alloc> buffer(elements);
+    for (size_t i = 0; i < elements; ++i) {
+        buffer.push_back(i);
+    }
+    auto filled = std::chrono::steady_clock::now();
+    std::cout << std::left << std::setw(48) << (name + " startup") << std::right << std::setw(12)
+              << std::chrono::duration<double, std::milli>(filled - start).count() << " ms\n";
+
+    std::mt19937_64 random(1);
+    uint64_t sum = 0;
+    print_result(name + " random operator[]", measure_ns(lookups, [&] {
+        sum += buffer[random() % elements];
+    }));
+    do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::stoull(argv[1]) : 512;
+    size_t elements = megabytes * 1024 * 1024 / sizeof(uint64_t);
+    const size_t klookups = 10'000'000;
+
+    std::cout << "buffer: " << megabytes << " MB, transparent huge pages: "
+              << (CHugePageAllocator<uint64_t>::transparent_huge_pages_available() ? "yes" : "no") << '\n';
+    run<std::allocator<uint64_t>>("std::allocator", elements, klookups);
+    run<CHugePageAllocator<uint64_t>>("huge pages", elements, klookups);
+    run<CHugePageAllocator<uint64_t, HugePagePrefault::populate>>("huge pages + MAP_POPULATE", elements, klookups);
+    run<CHugePageAllocator<uint64_t, HugePagePrefault::touch>>("huge pages + touch", elements, klookups);
+    return 0;
+}
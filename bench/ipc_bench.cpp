@@ -0,0 +1,84 @@
+#include "lib/CSharedMemoryRing.h"
+#include "bench/bench_util.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// One-way message throughput between two processes: a Unix socketpair (one write/read per
+// message) against CSharedMemoryRing with a futex-sleeping consumer.
+
+struct Event {
+    uint64_t sequence;
+    uint64_t timestamp;
+    uint64_t payload[2];
+};
+
+constexpr uint64_t kmessages = 1'000'000;
+
+template<typename Producer, typename Consumer>
+double run(Producer&& produce, Consumer&& consume) {
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        consume();
+        _exit(0);
+    }
+    produce();
+    int status = 0;
+    waitpid(pid, &status, 0);
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / kmessages;
+}
+
+int main() {
+    {
+        int fds[2];
+        socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds);
+        double ns = run([&] {
+            close(fds[1]);
+            for (uint64_t i = 0; i < kmessages; ++i) {
+                Event e{i, i, {i, i}};
+                if (write(fds[0], &e, sizeof(e)) != sizeof(e)) {
+                    break;
+                }
+            }
+            close(fds[0]);
+        }, [&] {
+            close(fds[0]);
+            Event e{};
+            uint64_t sum = 0;
+            while (read(fds[1], &e, sizeof(e)) == sizeof(e)) {
+                sum += e.payload[0];
+            }
+            do_not_optimize(sum);
+        });
+        print_result("socketpair SOCK_SEQPACKET", ns);
+    }
+    {
+        auto ring = CSharedMemoryRing<Event>::create_anonymous(4096);
+        double ns = run([&] {
+            for (uint64_t i = 0; i < kmessages; ++i) {
+                while (!ring.try_push({i, i, {i, i}})) {
+                    std::this_thread::yield();
+                }
+            }
+        }, [&] {
+            Event e{};
+            uint64_t sum = 0;
+            for (uint64_t i = 0; i < kmessages; ++i) {
+                if (!ring.pop_wait(e, std::chrono::seconds(10))) {
+                    break;
+                }
+                sum += e.payload[0];
+            }
+            do_not_optimize(sum);
+        });
+        print_result("CSharedMemoryRing", ns);
+    }
+    return 0;
+}
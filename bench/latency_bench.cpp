@@ -0,0 +1,173 @@
+#include "lib/CCircularBufferExt.h"
+#include "bench/bench_util.h"
+#include "bench/latency_histogram.h"
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Per-operation latency percentiles of CCircularBuffer operations.
+// Usage: latency_bench [--format=text|json|csv] [--clock=tsc|monotonic] [--iterations=N]
+
+struct Options {
+    std::string format = "text";
+    bool use_tsc = true;
+    size_t iterations = 200'000;
+};
+
+struct Result {
+    std::string operation;
+    std::string type;
+    size_t capacity;
+    const LatencyHistogram* histogram;
+};
+
+class Reporter {
+public:
+    Reporter(const Options& options, const LatencyClock& clock) : options_(options), clock_(clock) {
+        if (options_.format == "csv") {
+            std::cout << "operation,type,capacity,count,p50_ns,p99_ns,p999_ns,max_ns\n";
+        } else if (options_.format == "text") {
+            std::cout << "clock: " << clock_.name() << '\n'
+                      << std::left << std::setw(26) << "operation" << std::setw(8) << "type"
+                      << std::right << std::setw(10) << "capacity" << std::setw(10) << "count"
+                      << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+                      << std::setw(12) << "max (ns)" << '\n';
+        }
+    }
+
+    void report(const Result& r) const {
+        const LatencyHistogram& h = *r.histogram;
+        uint64_t p50 = clock_.to_ns(h.percentile(0.5));
+        uint64_t p99 = clock_.to_ns(h.percentile(0.99));
+        uint64_t p999 = clock_.to_ns(h.percentile(0.999));
+        uint64_t max = clock_.to_ns(h.max());
+        if (options_.format == "json") {
+            std::cout << "{\"operation\":\"" << r.operation << "\",\"type\":\"" << r.type
+                      << "\",\"capacity\":" << r.capacity << ",\"count\":" << h.count()
+                      << ",\"clock\":\"" << clock_.name() << "\",\"p50_ns\":" << p50
+                      << ",\"p99_ns\":" << p99 << ",\"p999_ns\":" << p999 << ",\"max_ns\":" << max << "}\n";
+        } else if (options_.format == "csv") {
+            std::cout << r.operation << ',' << r.type << ',' << r.capacity << ',' << h.count() << ','
+                      << p50 << ',' << p99 << ',' << p999 << ',' << max << '\n';
+        } else {
+            std::cout << std::left << std::setw(26) << r.operation << std::setw(8) << r.type
+                      << std::right << std::setw(10) << r.capacity << std::setw(10) << h.count()
+                      << std::setw(10) << p50 << std::setw(10) << p99 << std::setw(10) << p999
+                      << std::setw(12) << max << '\n';
+        }
+    }
+
+private:
+    const Options& options_;
+    const LatencyClock& clock_;
+};
+
+class Harness {
+public:
+    Harness(const Options& options, const LatencyClock& clock, const Reporter& reporter)
+            : options_(options), clock_(clock), reporter_(reporter) {}
+
+    // Times op() iterations times; setup() and teardown() run untimed around every call.
+    template<typename Setup, typename Op, typename Teardown>
+    void measure(const std::string& operation, const std::string& type, size_t capacity, size_t iterations,
+                 Setup&& setup, Op&& op, Teardown&& teardown) {
+        histogram_.reset();
+        for (size_t i = 0; i < iterations; ++i) {
+            setup();
+            uint64_t start = clock_.now();
+            op();
+            uint64_t finish = clock_.now();
+            teardown();
+            histogram_.record(finish - start);
+        }
+        reporter_.report({operation, type, capacity, &histogram_});
+    }
+
+    [[nodiscard]] size_t iterations() const noexcept { return options_.iterations; }
+
+private:
+    const Options& options_;
+    const LatencyClock& clock_;
+    const Reporter& reporter_;
+    LatencyHistogram histogram_;
+};
+
+template<typename T>
+void run(Harness& harness, const std::string& type, const T& value, size_t capacity) {
+    auto nothing = [] {};
+    size_t n = harness.iterations();
+    size_t shifting = std::max<size_t>(n / std::max<size_t>(capacity / 64, 1), 100);
+
+    CCircularBuffer<T> half(capacity);
+    while (half.size() < capacity / 2) {
+        half.push_back(value);
+    }
+    harness.measure("push_back", type, capacity, n, nothing,
+                    [&] { half.push_back(value); }, [&] { half.pop_front(); });
+    harness.measure("pop_front", type, capacity, n, [&] { half.push_back(value); },
+                    [&] { half.pop_front(); }, nothing);
+    harness.measure("insert_middle", type, capacity, shifting, nothing,
+                    [&] { half.insert(half.cbegin() + half.size() / 2, value); },
+                    [&] { half.pop_back(); });
+    harness.measure("erase_middle", type, capacity, shifting, [&] { half.push_back(value); },
+                    [&] { half.erase(half.cbegin() + half.size() / 2); }, nothing);
+
+    CCircularBuffer<T> full(capacity);
+    while (full.size() < capacity) {
+        full.push_back(value);
+    }
+#if defined(__cpp_exceptions)
+    harness.measure("push_back_full_throw", type, capacity, n, nothing, [&] {
+        try {
+            full.push_back(value);
+        } catch (const FullBufferException&) {
+            do_not_optimize(full);
+        }
+    }, nothing);
+#endif
+    harness.measure("try_push_back_full", type, capacity, n, nothing, [&] {
+        bool pushed = full.try_push_back(value);
+        do_not_optimize(pushed);
+    }, nothing);
+
+    // Every push into a growing CCircularBufferExt, including the double_up pauses.
+    CCircularBufferExt<T> growing;
+    size_t rounds = std::max<size_t>(n / capacity, 1);
+    harness.measure("ext_push_back_growth", type, capacity, rounds * capacity, [&] {
+        if (growing.size() == capacity) {
+            growing = CCircularBufferExt<T>();
+        }
+    }, [&] { growing.push_back(value); }, nothing);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--format=", 0) == 0) {
+            options.format = arg.substr(std::strlen("--format="));
+        } else if (arg == "--clock=monotonic") {
+            options.use_tsc = false;
+        } else if (arg == "--clock=tsc") {
+            options.use_tsc = true;
+        } else if (arg.rfind("--iterations=", 0) == 0) {
+            options.iterations = std::stoull(arg.substr(std::strlen("--iterations=")));
+        } else {
+            std::cerr << "usage: " << argv[0]
+                      << " [--format=text|json|csv] [--clock=tsc|monotonic] [--iterations=N]\n";
+            return 1;
+        }
+    }
+
+    LatencyClock clock(options.use_tsc);
+    Reporter reporter(options, clock);
+    Harness harness(options, clock, reporter);
+    for (size_t capacity: {1024, 65536}) {
+        run<int>(harness, "int", 42, capacity);
+        run<std::string>(harness, "string", std::string(48, 'x'), capacity);
+    }
+    return 0;
+}
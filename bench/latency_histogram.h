@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "lib/CLogLinearBuckets.h"
+
+// Log-bucketed histogram in the style of HdrHistogram: values below 128 are exact,
+// larger values keep 7 significant bits (relative error below 2^-6, about 1.6%).
+class LatencyHistogram {
+public:
+    void record(uint64_t value) noexcept {
+        ++counts_[Buckets::bucket(value)];
+        ++total_;
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+    }
+
+    // Smallest recorded bucket bound below which a fraction q (0..1) of the values lie.
+    [[nodiscard]] uint64_t percentile(double q) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(q * static_cast<double>(total_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(Buckets::upper_bound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    [[nodiscard]] uint64_t count() const noexcept { return total_; }
+
+    [[nodiscard]] uint64_t max() const noexcept { return max_; }
+
+    [[nodiscard]] uint64_t min() const noexcept { return total_ == 0 ? 0 : min_; }
+
+    void reset() noexcept {
+        counts_.fill(0);
+        total_ = 0;
+        max_ = 0;
+        min_ = UINT64_MAX;
+    }
+
+private:
+    using Buckets = CLogLinearBuckets<7>;
+
+    std::array<uint64_t, Buckets::kcount> counts_{};
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+    uint64_t min_ = UINT64_MAX;
+};
+
+// Timestamp source: rdtsc on x86 (calibrated against CLOCK_MONOTONIC), clock_gettime elsewhere.
+class LatencyClock {
+public:
+    explicit LatencyClock(bool use_tsc) : use_tsc_(use_tsc && tsc_available()) {
+        if (use_tsc_) {
+            calibrate();
+        }
+    }
+
+    [[nodiscard]] uint64_t now() const noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        if (use_tsc_) {
+            unsigned aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return monotonic_ns();
+    }
+
+    [[nodiscard]] uint64_t to_ns(uint64_t ticks) const noexcept {
+        return use_tsc_ ? static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick_) : ticks;
+    }
+
+    [[nodiscard]] const char* name() const noexcept { return use_tsc_ ? "rdtscp" : "clock_gettime"; }
+
+private:
+    static constexpr bool tsc_available() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static uint64_t monotonic_ns() noexcept {
+        timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+    }
+
+    void calibrate() noexcept {
+        uint64_t ns_start = monotonic_ns();
+        uint64_t ticks_start = now();
+        while (monotonic_ns() - ns_start < 50'000'000) {
+        }
+        uint64_t ns = monotonic_ns() - ns_start;
+        uint64_t ticks = now() - ticks_start;
+        ns_per_tick_ = static_cast<double>(ns) / static_cast<double>(ticks);
+    }
+
+    bool use_tsc_;
+    double ns_per_tick_ = 1.0;
+};
@@ -0,0 +1,59 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CCircularBufferMerge.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Globally ordered stream out of k timestamp-sorted rings: copy everything into a vector and sort
+// it, against CCircularBufferMerge::drain_merged.
+
+struct Sample {
+    uint64_t timestamp;
+    uint64_t value;
+};
+
+constexpr size_t ktotal = 1'000'000;
+
+int main() {
+    auto by_timestamp = [](const Sample& a, const Sample& b) { return a.timestamp < b.timestamp; };
+    std::mt19937_64 rng(4);
+
+    for (size_t k: {2, 8, 64, 512}) {
+        std::vector<CCircularBuffer<Sample>> buffers;
+        std::vector<CCircularBuffer<Sample>*> sources;
+        buffers.reserve(k);
+        for (size_t s = 0; s < k; ++s) {
+            buffers.emplace_back(ktotal / k);
+            uint64_t t = 0;
+            for (size_t i = 0; i < ktotal / k; ++i) {
+                t += rng() % 1000;
+                buffers.back().push_back({t, s});
+            }
+            sources.push_back(&buffers.back());
+        }
+        std::vector<Sample> out(ktotal);
+        std::string suffix = " k=" + std::to_string(k);
+
+        print_result("copy + std::sort" + suffix, measure_ns(3, [&] {
+            size_t n = 0;
+            for (auto& buffer: buffers) {
+                for (auto part: buffer.segments()) {
+                    std::copy(part.begin(), part.end(), out.begin() + static_cast<std::ptrdiff_t>(n));
+                    n += part.size();
+                }
+            }
+            std::sort(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(n), by_timestamp);
+            do_not_optimize(out[0]);
+        }) / ktotal);
+
+        print_result("drain_merged" + suffix, measure_ns(3, [&] {
+            CCircularBufferMerge<CCircularBuffer<Sample>, decltype(by_timestamp)> merge(sources, by_timestamp);
+            merge.drain_merged(out.begin());
+            do_not_optimize(out[0]);
+        }) / ktotal);
+    }
+    return 0;
+}
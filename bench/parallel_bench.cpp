@@ -0,0 +1,93 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CCircularBufferParallel.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Scaling of the parallel algorithms over a wrapped CCircularBuffer<double>, against the serial
+// standard algorithms on normal_iterator and on segments() | std::views::join.
+
+constexpr size_t kelements = 2'000'000;
+
+CCircularBuffer<double> make_buffer(const std::vector<double>& values) {
+    CCircularBuffer<double> buffer(values.size());
+    for (size_t i = 0; i < values.size() / 3; ++i) {
+        buffer.push_back(0.0);
+    }
+    for (size_t i = 0; i < values.size() / 3; ++i) {
+        buffer.pop_front();
+    }
+    for (double v: values) {
+        buffer.push_back(v);
+    }
+    return buffer;
+}
+
+int main() {
+    std::vector<double> values(kelements);
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    for (double& v: values) {
+        v = dist(rng);
+    }
+    CCircularBuffer<double> buffer = make_buffer(values);
+    std::vector<double> out(kelements);
+
+    print_result("serial std::for_each", measure_ns(3, [&] {
+        std::for_each(buffer.begin(), buffer.end(), [](double& x) { x = std::sqrt(x); });
+    }) / kelements);
+    print_result("serial std::reduce", measure_ns(3, [&] {
+        do_not_optimize(std::reduce(buffer.begin(), buffer.end(), 0.0));
+    }) / kelements);
+    print_result("serial sum over joined segments", measure_ns(3, [&] {
+        double sum = 0.0;
+        for (double x: buffer.segments() | std::views::join) {
+            sum += x;
+        }
+        do_not_optimize(sum);
+    }) / kelements);
+    print_result("serial std::transform", measure_ns(3, [&] {
+        std::transform(buffer.begin(), buffer.end(), out.begin(), [](double x) { return x * x; });
+    }) / kelements);
+
+    size_t max_threads = std::max(2u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::string suffix = " threads=" + std::to_string(threads);
+        print_result("parallel_for_each" + suffix, measure_ns(3, [&] {
+            parallel_for_each(buffer, [](double& x) { x = std::sqrt(x); }, threads);
+        }) / kelements);
+        print_result("parallel_reduce" + suffix, measure_ns(3, [&] {
+            do_not_optimize(parallel_reduce(buffer, 0.0, std::plus<>(), threads));
+        }) / kelements);
+        print_result("parallel_transform" + suffix, measure_ns(3, [&] {
+            parallel_transform(buffer, out.begin(), [](double x) { return x * x; }, threads);
+        }) / kelements);
+        print_result("parallel_find_if" + suffix, measure_ns(3, [&] {
+            do_not_optimize(parallel_find_if(buffer, [](double x) { return x > 2.0; }, threads));
+        }) / kelements);
+    }
+
+    // Sorting consumes the input, so every run starts from a fresh copy.
+    double serial_sort_ns = 0;
+    for (int run = 0; run < 3; ++run) {
+        CCircularBuffer<double> copy = make_buffer(values);
+        serial_sort_ns += measure_ns(1, [&] { std::sort(copy.begin(), copy.end()); });
+    }
+    print_result("serial std::sort", serial_sort_ns / 3 / kelements);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double ns = 0;
+        for (int run = 0; run < 3; ++run) {
+            CCircularBuffer<double> copy = make_buffer(values);
+            ns += measure_ns(1, [&] { parallel_sort(copy, std::less<>(), threads); });
+        }
+        print_result("parallel_sort threads=" + std::to_string(threads), ns / 3 / kelements);
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CWindowedQuantile.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rolling p50/p95/p99 after every push: sorting a copy of the window against
+// CWindowedQuantile (exact) and CWindowedQuantileSketch (approximate).
+
+constexpr size_t kiterations = 20'000;
+
+std::vector<uint64_t> make_latencies() {
+    std::mt19937_64 rng(3);
+    std::lognormal_distribution<double> latency(9.0, 1.0);
+    std::vector<uint64_t> values(kiterations);
+    for (uint64_t& v: values) {
+        v = static_cast<uint64_t>(latency(rng));
+    }
+    return values;
+}
+
+void run(size_t window, const std::vector<uint64_t>& latencies) {
+    std::string suffix = " window=" + std::to_string(window);
+
+    {
+        CCircularBuffer<uint64_t> ring(window);
+        std::vector<uint64_t> copy;
+        size_t i = 0;
+        double ns = measure_ns(kiterations, [&] {
+            if (ring.size() == ring.capacity()) {
+                ring.pop_front();
+            }
+            ring.push_back(latencies[i++ % latencies.size()]);
+            copy.assign(ring.begin(), ring.end());
+            std::sort(copy.begin(), copy.end());
+            for (double q: {0.5, 0.95, 0.99}) {
+                do_not_optimize(copy[static_cast<size_t>(q * (copy.size() - 1))]);
+            }
+        });
+        print_result("sort copy" + suffix, ns);
+    }
+    {
+        CWindowedQuantile<uint64_t> quantiles(window);
+        size_t i = 0;
+        double ns = measure_ns(kiterations, [&] {
+            quantiles.push(latencies[i++ % latencies.size()]);
+            for (double q: {0.5, 0.95, 0.99}) {
+                do_not_optimize(quantiles.quantile(q));
+            }
+        });
+        print_result("CWindowedQuantile" + suffix, ns);
+    }
+    {
+        CWindowedQuantileSketch<> quantiles(window);
+        size_t i = 0;
+        double ns = measure_ns(kiterations, [&] {
+            quantiles.push(latencies[i++ % latencies.size()]);
+            for (double q: {0.5, 0.95, 0.99}) {
+                do_not_optimize(quantiles.quantile(q));
+            }
+        });
+        print_result("CWindowedQuantileSketch" + suffix, ns);
+    }
+}
+
+int main() {
+    std::vector<uint64_t> latencies = make_latencies();
+    for (size_t window: {128, 1024, 16384}) {
+        run(window, latencies);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "lib/CCircularBufferExt.h"
+#include "lib/CTimeBucketRing.h"
+#include "bench/bench_util.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Counting events over the last 60s at 100ms resolution, 10k events per second of simulated time:
+// per-event timestamps in a growing ring against CTimeBucketRing, plus concurrent recording into
+// CAtomicTimeBucketRing.
+
+using namespace std::chrono_literals;
+using Time = std::chrono::steady_clock::time_point;
+
+constexpr size_t kiterations = 2'000'000;
+constexpr auto kstep = 100us;
+
+int main() {
+    Time start(1h);
+    {
+        CCircularBufferExt<Time> events(1024);
+        Time now = start;
+        print_result("timestamp ring add+count", measure_ns(kiterations, [&] {
+            now += kstep;
+            events.push_back(now);
+            while (events.front() <= now - 60s) {
+                events.pop_front();
+            }
+            do_not_optimize(events.size());
+        }));
+        std::printf("  memory %zu bytes\n", events.capacity() * sizeof(Time));
+    }
+    {
+        CTimeBucketRing<uint32_t> ring(600, 100ms, start);
+        Time now = start;
+        print_result("CTimeBucketRing add+total", measure_ns(kiterations, [&] {
+            now += kstep;
+            ring.add(now);
+            do_not_optimize(ring.total(now));
+        }));
+        std::printf("  memory %zu bytes\n", ring.size() * sizeof(uint32_t));
+    }
+    for (size_t threads: {1, 4}) {
+        CAtomicTimeBucketRing<> ring(600, 100ms);
+        std::vector<std::thread> workers;
+        double ns = measure_ns(1, [&] {
+            for (size_t t = 1; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (size_t i = 0; i < kiterations; ++i) {
+                        ring.add();
+                    }
+                });
+            }
+            for (size_t i = 0; i < kiterations; ++i) {
+                ring.add();
+            }
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }) / kiterations;
+        print_result("CAtomicTimeBucketRing add threads=" + std::to_string(threads), ns);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CSeqlockCircularBuffer.h"
+#include "bench/bench_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Writer and reader throughput of CSeqlockCircularBuffer against a std::shared_mutex guarded
+// CCircularBuffer, one writer publishing quotes and a growing number of read_latest(k) readers.
+
+struct Quote {
+    uint64_t sequence;
+    double bid;
+    double ask;
+    uint64_t volume;
+};
+
+constexpr size_t kcapacity = 1024;
+constexpr size_t klatest = 8;
+constexpr auto kduration = std::chrono::milliseconds(500);
+
+class LockedRing {
+public:
+    LockedRing() : buffer_(kcapacity) {}
+
+    void push_back(const Quote& q) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (buffer_.size() == buffer_.capacity()) {
+            buffer_.pop_front();
+        }
+        buffer_.push_back(q);
+    }
+
+    size_t read_latest(size_t k, Quote* out) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        size_t n = std::min(k, buffer_.size());
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = buffer_[buffer_.size() - n + i];
+        }
+        return n;
+    }
+
+private:
+    std::shared_mutex mutex_;
+    CCircularBuffer<Quote> buffer_;
+};
+
+template<typename Ring>
+void run(const std::string& name, size_t readers) {
+    Ring ring;
+    std::atomic<uint64_t> reads{0};
+    // Readers stop on their own too, a reader-preferring lock may starve the writer completely.
+    auto deadline = std::chrono::steady_clock::now() + kduration;
+
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            Quote out[klatest];
+            uint64_t n = 0;
+            while ((n & 255) != 0 || std::chrono::steady_clock::now() < deadline) {
+                ring.read_latest(klatest, out);
+                do_not_optimize(out);
+                ++n;
+            }
+            reads += n;
+        });
+    }
+
+    uint64_t writes = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() < deadline) {
+        for (int i = 0; i < 64; ++i) {
+            ring.push_back({writes, 1.0, 2.0, writes});
+            ++writes;
+        }
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(16) << name << " readers=" << std::setw(4) << readers << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << writes / seconds << " writes/s"
+              << std::setw(14) << reads / seconds << " reads/s\n";
+}
+
+struct SeqlockRing : CSeqlockCircularBuffer<Quote> {
+    SeqlockRing() : CSeqlockCircularBuffer<Quote>(kcapacity) {}
+};
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << '\n';
+    for (size_t readers: {1, 2, 4, 8, 16, 32}) {
+        run<SeqlockRing>("seqlock", readers);
+        run<LockedRing>("shared_mutex", readers);
+    }
+    return 0;
+}
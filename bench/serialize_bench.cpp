@@ -0,0 +1,58 @@
+#include "lib/CCircularBuffer.h"
+#include "bench/bench_util.h"
+
+#include <cstring>
+#include <vector>
+
+// Snapshot and restore of a wrapped CCircularBuffer<uint64_t> through an in-memory byte stream:
+// serialize()/deserialize() against an element loop over begin()/end() and push_back().
+
+constexpr size_t kelements = 1 << 20;
+
+int main() {
+    CCircularBuffer<uint64_t> buffer(kelements);
+    for (size_t i = 0; i < kelements + kelements / 3; ++i) {
+        if (buffer.size() == buffer.capacity()) {
+            buffer.pop_front();
+        }
+        buffer.push_back(i);
+    }
+    std::vector<std::byte> bytes;
+    bytes.reserve(kelements * sizeof(uint64_t) + 64);
+
+    print_result("element loop write", measure_ns(5, [&] {
+        bytes.clear();
+        for (uint64_t value: buffer) {
+            auto p = reinterpret_cast<const std::byte*>(&value);
+            bytes.insert(bytes.end(), p, p + sizeof(value));
+        }
+    }) / kelements);
+    print_result("element loop restore", measure_ns(5, [&] {
+        CCircularBuffer<uint64_t> copy(kelements);
+        for (size_t offset = 0; offset < bytes.size(); offset += sizeof(uint64_t)) {
+            uint64_t value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(value));
+            copy.push_back(value);
+        }
+        do_not_optimize(copy.size());
+    }) / kelements);
+
+    auto writer = [&](const void* data, size_t size) {
+        auto p = static_cast<const std::byte*>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    };
+    print_result("serialize", measure_ns(5, [&] {
+        bytes.clear();
+        buffer.serialize(writer);
+    }) / kelements);
+    print_result("deserialize", measure_ns(5, [&] {
+        CCircularBuffer<uint64_t> copy;
+        size_t offset = 0;
+        copy.deserialize([&](void* data, size_t size) {
+            std::memcpy(data, bytes.data() + offset, size);
+            offset += size;
+        });
+        do_not_optimize(copy.size());
+    }) / kelements);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "lib/CCircularBufferExt.h"
+#include "lib/CSpillingQueue.h"
+#include "bench/bench_util.h"
+
+#include <filesystem>
+#include <string>
+
+// A stalled consumer: kelements are queued first and drained afterwards. CCircularBufferExt grows
+// to hold everything, CSpillingQueue stays within its memory budget and goes through the disk.
+
+struct Message {
+    uint64_t sequence;
+    uint64_t payload[7];
+};
+
+constexpr size_t kelements = 2'000'000;
+
+template<typename Queue>
+double fill_and_drain(Queue& queue) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < kelements; ++i) {
+        queue.push_back(Message{i, {i}});
+    }
+    uint64_t sum = 0;
+    while (!queue.empty()) {
+        sum += queue.front().sequence;
+        queue.pop_front();
+    }
+    do_not_optimize(sum);
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / kelements;
+}
+
+int main() {
+    {
+        CCircularBufferExt<Message> queue(16);
+        print_result("CCircularBufferExt (" + std::to_string(kelements * sizeof(Message) >> 20) + " MiB)",
+                     fill_and_drain(queue));
+    }
+
+    std::string directory = std::filesystem::temp_directory_path().string();
+    for (size_t budget: {size_t(1) << 20, size_t(16) << 20}) {
+        CSpillingQueue<Message> queue(budget, directory);
+        print_result("CSpillingQueue budget=" + std::to_string(budget >> 20) + " MiB", fill_and_drain(queue));
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include "lib/CCircularBufferExt.h"
+#include "lib/CWorkStealingDeque.h"
+#include "bench/bench_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fork-join scaling of a small work-stealing scheduler: parallel fib and quicksort with
+// per-worker CWorkStealingDeque against the same scheduler on mutex-guarded CCircularBufferExt.
+
+struct Task {
+    std::function<void()> body;
+    std::atomic<bool> done{false};
+};
+
+class LockedDeque {
+public:
+    void push(Task* task) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer_.push_back(task);
+    }
+
+    std::optional<Task*> pop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer_.empty()) {
+            return std::nullopt;
+        }
+        Task* task = buffer_.back();
+        buffer_.pop_back();
+        return task;
+    }
+
+    std::optional<Task*> steal() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer_.empty()) {
+            return std::nullopt;
+        }
+        Task* task = buffer_.front();
+        buffer_.pop_front();
+        return task;
+    }
+
+private:
+    std::mutex mutex_;
+    CCircularBufferExt<Task*> buffer_{64};
+};
+
+// The calling thread is worker 0; spawn() and wait() may only be called from worker threads.
+template<typename Deque>
+class Scheduler {
+public:
+    explicit Scheduler(size_t workers) : deques_(workers) {
+        for (auto& deque: deques_) {
+            deque = std::make_unique<Deque>();
+        }
+        worker_id_ = 0;
+        for (size_t i = 1; i < workers; ++i) {
+            threads_.emplace_back([this, i] {
+                worker_id_ = i;
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    if (!run_one()) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+    }
+
+    ~Scheduler() {
+        stop_.store(true);
+        for (auto& thread: threads_) {
+            thread.join();
+        }
+    }
+
+    void spawn(Task& task) {
+        deques_[worker_id_]->push(&task);
+    }
+
+    // Runs other tasks until task is finished.
+    void wait(Task& task) {
+        while (!task.done.load(std::memory_order_acquire)) {
+            if (!run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    bool run_one() {
+        std::optional<Task*> task = deques_[worker_id_]->pop();
+        for (size_t i = 1; !task && i < deques_.size(); ++i) {
+            task = deques_[(worker_id_ + i) % deques_.size()]->steal();
+        }
+        if (!task) {
+            return false;
+        }
+        (*task)->body();
+        (*task)->done.store(true, std::memory_order_release);
+        return true;
+    }
+
+    static inline thread_local size_t worker_id_ = 0;
+
+    std::vector<std::unique_ptr<Deque>> deques_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+};
+
+constexpr int kfib = 30;
+constexpr int kfib_cutoff = 12;
+constexpr size_t ksort_size = 2'000'000;
+constexpr size_t ksort_cutoff = 4096;
+
+uint64_t serial_fib(int n) {
+    return n < 2 ? n : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+template<typename Deque>
+uint64_t fib(Scheduler<Deque>& scheduler, int n) {
+    if (n < kfib_cutoff) {
+        return serial_fib(n);
+    }
+    uint64_t left = 0;
+    Task child{[&] { left = fib(scheduler, n - 1); }};
+    scheduler.spawn(child);
+    uint64_t right = fib(scheduler, n - 2);
+    scheduler.wait(child);
+    return left + right;
+}
+
+template<typename Deque>
+void quicksort(Scheduler<Deque>& scheduler, int* first, int* last) {
+    if (last - first < static_cast<std::ptrdiff_t>(ksort_cutoff)) {
+        std::sort(first, last);
+        return;
+    }
+    int pivot = first[(last - first) / 2];
+    int* middle1 = std::partition(first, last, [pivot](int x) { return x < pivot; });
+    int* middle2 = std::partition(middle1, last, [pivot](int x) { return x == pivot; });
+    Task child{[&] { quicksort(scheduler, first, middle1); }};
+    scheduler.spawn(child);
+    quicksort(scheduler, middle2, last);
+    scheduler.wait(child);
+}
+
+template<typename Deque>
+void run(const std::string& name, size_t workers, const std::vector<int>& input) {
+    Scheduler<Deque> scheduler(workers);
+
+    uint64_t result = 0;
+    double fib_ns = measure_ns(5, [&] { result = fib(scheduler, kfib); });
+    do_not_optimize(result);
+    if (result != serial_fib(kfib)) {
+        std::cerr << "fib mismatch\n";
+    }
+    print_result(name + " fib(" + std::to_string(kfib) + ") x" + std::to_string(workers), fib_ns);
+
+    std::vector<int> data;
+    double sort_ns = measure_ns(3, [&] {
+        data = input;
+        quicksort(scheduler, data.data(), data.data() + data.size());
+    });
+    if (!std::is_sorted(data.begin(), data.end())) {
+        std::cerr << "quicksort produced unsorted output\n";
+    }
+    print_result(name + " quicksort x" + std::to_string(workers), sort_ns);
+}
+
+int main() {
+    std::vector<int> input(ksort_size);
+    std::mt19937 rng(42);
+    for (int& x: input) {
+        x = static_cast<int>(rng());
+    }
+
+    size_t max_workers = std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+        run<CWorkStealingDeque<Task*>>("chase-lev", workers, input);
+        run<LockedDeque>("mutex + CCircularBufferExt", workers, input);
+    }
+    return 0;
+}
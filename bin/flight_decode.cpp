@@ -0,0 +1,42 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "lib/CFlightRecorder.h"
+
+// Prints a CFlightRecorder dump, one event per line in timestamp order:
+//   <ns relative to the last event> <thread> <code> <arg0> <arg1>
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <dump file>\n";
+        return 2;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto recording = parse_flight_dump(std::as_bytes(std::span<const char>(bytes)));
+    if (!recording) {
+        std::cerr << argv[1] << " is not a flight recorder dump\n";
+        return 1;
+    }
+
+    std::cout << "threads: " << recording->threads.size();
+    if (recording->header.dropped_threads > 0) {
+        std::cout << " (" << recording->header.dropped_threads << " not recorded)";
+    }
+    std::cout << "\n";
+    for (const FlightDumpThread& thread: recording->threads) {
+        std::cout << "thread " << thread.thread << " tid " << thread.os_thread << ": " << thread.count
+                  << " of " << thread.written << " events\n";
+    }
+
+    uint64_t last = recording->events.empty() ? 0 : recording->events.back().timestamp;
+    for (const FlightEvent& event: recording->events) {
+        std::cout << -static_cast<int64_t>(last - event.timestamp) << " " << event.thread << " " << event.code
+                  << " " << event.args[0] << " " << event.args[1] << "\n";
+    }
+    return 0;
+}
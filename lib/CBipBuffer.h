@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+// Bipartite circular buffer: data lives in region A and, once the space after A runs out,
+// in region B at the start of the storage. Every write reservation and every read block is
+// contiguous, the wrap point is never split.
+//
+// Writers call reserve(n), fill the span and commit(k) with k <= n. Readers take read_block()
+// and release what they used with consume(k).
+template<typename T = std::byte, typename Alloc = std::allocator<T>>
+class CBipBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "CBipBuffer holds raw trivially copyable data");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using Alloc_traits = std::allocator_traits<Alloc>;
+
+    explicit CBipBuffer(size_t capacity, const Alloc& allocator = Alloc())
+            : allocator_(allocator), capacity_(capacity),
+              start_in_memory_(Alloc_traits::allocate(allocator_, capacity_)) {}
+
+    CBipBuffer(const CBipBuffer&) = delete;
+
+    CBipBuffer& operator=(const CBipBuffer&) = delete;
+
+    ~CBipBuffer() {
+        Alloc_traits::deallocate(allocator_, start_in_memory_, capacity_);
+    }
+
+    // Contiguous space for n elements, or an empty span if no contiguous n elements are free.
+    // A new reservation replaces the previous uncommitted one.
+    std::span<T> reserve(size_t n) noexcept {
+        reserved_size_ = 0;
+        if (b_end_ > 0 || (a_start_ >= n && capacity_ - a_end_ < n)) {
+            // Region B grows from 0 up to the start of region A.
+            if (b_end_ + n > a_start_) {
+                return {};
+            }
+            reserved_start_ = b_end_;
+        } else {
+            if (a_end_ + n > capacity_) {
+                return {};
+            }
+            reserved_start_ = a_end_;
+        }
+        reserved_size_ = n;
+        return {start_in_memory_ + reserved_start_, n};
+    }
+
+    // Makes the first n reserved elements readable.
+    void commit(size_t n) noexcept {
+        if (n > reserved_size_) {
+            n = reserved_size_;
+        }
+        if (n > 0) {
+            if (a_start_ == a_end_) {
+                a_start_ = reserved_start_;
+                a_end_ = reserved_start_ + n;
+            } else if (reserved_start_ == a_end_ && b_end_ == 0) {
+                a_end_ += n;
+            } else {
+                b_end_ += n;
+            }
+        }
+        reserved_size_ = 0;
+    }
+
+    // Oldest committed data that is contiguous in memory.
+    [[nodiscard]] std::span<const T> read_block() const noexcept {
+        return {start_in_memory_ + a_start_, a_end_ - a_start_};
+    }
+
+    [[nodiscard]] std::span<T> read_block() noexcept {
+        return {start_in_memory_ + a_start_, a_end_ - a_start_};
+    }
+
+    // Releases the first n elements of read_block().
+    void consume(size_t n) noexcept {
+        if (n > a_end_ - a_start_) {
+            n = a_end_ - a_start_;
+        }
+        a_start_ += n;
+        if (a_start_ == a_end_) {
+            a_start_ = 0;
+            a_end_ = b_end_;
+            b_end_ = 0;
+        }
+    }
+
+    // Committed elements in both regions.
+    [[nodiscard]] size_t size() const noexcept { return a_end_ - a_start_ + b_end_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] size_t reserved() const noexcept { return reserved_size_; }
+
+    void clear() noexcept {
+        a_start_ = a_end_ = b_end_ = 0;
+        reserved_size_ = 0;
+    }
+
+private:
+    Alloc allocator_;
+    size_t capacity_;
+    T* start_in_memory_;
+    size_t a_start_ = 0;
+    size_t a_end_ = 0;
+    size_t b_end_ = 0;
+    size_t reserved_start_ = 0;
+    size_t reserved_size_ = 0;
+};
@@ -1,2 +1,4 @@
 #include "CCircularBufferExt.h"
 
+template class CCircularBuffer<int>;
+template class CCircularBufferExt<int>;
@@ -1,14 +1,36 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "CCircularBufferSerialization.h"
 #include "normal_iterator.h"
 
-class FullBufferException : std::exception {
+// Without exception support (-fno-exceptions) errors terminate the program,
+// use the try_ methods to handle a full or empty buffer.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define CB_THROW(exception) throw exception
+#else
+#define CB_THROW(exception) std::abort()
+#endif
+
+class FullBufferException : public std::exception {
+public:
     const char* what() const noexcept override {
         return "Buffer is full";
     }
 };
 
-class EmptyBufferException : std::exception {
+class EmptyBufferException : public std::exception {
+public:
     const char* what() const noexcept override {
         return "Buffer is empty";
     }
@@ -86,7 +108,7 @@ public:
               size_(l.size()), allocator_(allocator) {
         size_t j = head_;
         for (auto i = l.begin(); i != l.end(); i++, j++) {
-            Alloc_traits::construct(allocator, start_in_memory_ + j % capacity_, *i);
+            Alloc_traits::construct(allocator_, start_in_memory_ + j % capacity_, *i);
         }
     }
 
@@ -181,19 +203,19 @@ public:
     }
 
     constexpr iterator begin() noexcept {
-        return iterator(head_, start_in_memory_, head_, size_, capacity_);
+        return iterator(start_in_memory_, capacity_, head_, 0);
     }
 
     constexpr const_iterator begin() const noexcept {
-        return const_iterator(head_, start_in_memory_, head_, size_, capacity_);
+        return const_iterator(start_in_memory_, capacity_, head_, 0);
     }
 
     constexpr iterator end() noexcept {
-        return iterator(head_ + size_, start_in_memory_, head_, size_, capacity_);
+        return iterator(start_in_memory_, capacity_, head_, size_);
     }
 
     constexpr const_iterator end() const noexcept {
-        return const_iterator(head_ + size_, start_in_memory_, head_, size_, capacity_);
+        return const_iterator(start_in_memory_, capacity_, head_, size_);
     }
 
     constexpr const_iterator cbegin() const noexcept {
@@ -234,61 +256,38 @@ public:
     // Sequence container
 
     template<typename... Args>
-    constexpr iterator emplace(const_iterator cp, Args&& ...args) {
-        return insert(cp, std::forward<Args>(args)...);
-    }
-
-    virtual iterator insert(const_iterator cp, const T& t) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
+    iterator emplace(const_iterator cp, Args&& ...args) {
+        size_t n = cp - cbegin();
+        if (!ensure_room(1)) {
+            CB_THROW(FullBufferException());
         }
 
-        if (cp == cend()) {
+        if (n == size_) {
+            Alloc_traits::construct(allocator_, slot(size_), std::forward<Args>(args)...);
             ++size_;
-            Alloc_traits::construct(allocator_, &*(end() - 1), t);
-            return (end() - 1);
+            return begin() + n;
         }
+
+        Alloc_traits::construct(allocator_, slot(size_), std::move(*slot(size_ - 1)));
         ++size_;
-        int n = cp - cbegin();
-        iterator p = begin() + n;
-        iterator i = end() - 1;
-        Alloc_traits::construct(allocator_, &(*i), *(i - 1));
-        --i;
-        while (i != p) {
-            T* ptr = &(*i);
-            Alloc_traits::destroy(allocator_, ptr);
-            Alloc_traits::construct(allocator_, ptr, *(i - 1));
-            --i;
+        for (size_t k = size_ - 2; k > n; --k) {
+            *slot(k) = std::move(*slot(k - 1));
         }
-        Alloc_traits::construct(allocator_, &(*i), t);
-        return i;
-    }
-
-    virtual iterator insert(const_iterator cp, T&& t) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+            Alloc_traits::destroy(allocator_, slot(n));
+            Alloc_traits::construct(allocator_, slot(n), std::forward<Args>(args)...);
+        } else {
+            *slot(n) = T(std::forward<Args>(args)...);
         }
+        return begin() + n;
+    }
 
-        if (cp == cend()) {
-            ++size_;
-            Alloc_traits::construct(allocator_, &*(end() - 1), t);
-            return (end() - 1);
-        }
+    iterator insert(const_iterator cp, const T& t) {
+        return emplace(cp, t);
+    }
 
-        ++size_;
-        int n = cp - cbegin();
-        iterator p = begin() + n;
-        iterator i = end() - 1;
-        Alloc_traits::construct(allocator_, &(*i), *(i - 1));
-        --i;
-        while (i != p) {
-            T* ptr = &(*i);
-            Alloc_traits::destroy(allocator_, ptr);
-            Alloc_traits::construct(allocator_, ptr, *(i - 1));
-            --i;
-        }
-        Alloc_traits::construct(allocator_, &(*i), t);
-        return i;
+    iterator insert(const_iterator cp, T&& t) {
+        return emplace(cp, std::move(t));
     }
 
     constexpr iterator insert(const_iterator cp, size_t n, T t) {
@@ -305,142 +304,49 @@ public:
         return insert(cp, CCircularBuffer(il.begin(), il.end()));
     }
 
-    virtual iterator insert(const_iterator cp,
-                            const CCircularBuffer<T>& a) {
-        if (size_ + a.size_ > capacity_) {
-            throw FullBufferException();
-        }
-
-        int n = a.size_;
-        if (cp == cend()) {
-            size_ += n;
-            if (size_ > capacity_)
-                size_ %= capacity_;
-            auto t = (end() - n);
-            for (auto i = end() - 1, k = a.end() - 1; i != (end() - n); --i, --k) {
-                Alloc_traits::construct(allocator_, &(*i), *k);
-            }
-            Alloc_traits::construct(allocator_, &*(end() - n), *a.begin());
-
-            return (end() - n);
-        }
-        int distance = cp - cbegin();
-
-        size_ += n;
-        if (size_ > capacity_) {
-            size_ %= capacity_;
-        }
-
-        iterator p = begin() + distance;
-        iterator i = end() - 1;
-        while (i != p) {
-            T* ptr = &(*i);
-            if (i <= end() - n) {
-                Alloc_traits::destroy(allocator_, ptr);
-            }
-
-            Alloc_traits::construct(allocator_, ptr, *(i - n));
-            --i;
-        }
-
-        for (auto j = i, k = a.cbegin(); j < i + n; ++j, ++k) {
-            Alloc_traits::construct(allocator_, &(*j), *k);
-        }
-        return i;
+    iterator insert(const_iterator cp, const CCircularBuffer<T>& a) {
+        return insert_buffer(cp, a);
     }
 
-    virtual iterator insert(const_iterator cp, CCircularBuffer<T>&& a) {
-        if (size_ + a.size_ > capacity_) {
-            throw FullBufferException();
-        }
-
-        int n = a.size_;
-        if (cp == cend()) {
-            size_ += n;
-            if (size_ > capacity_)
-                size_ %= capacity_;
-            auto t = (end() - n);
-            for (auto i = end() - 1, k = a.end() - 1; i != (end() - n); --i, --k) {
-                Alloc_traits::construct(allocator_, &(*i), *k);
-            }
-            Alloc_traits::construct(allocator_, &*(end() - n), *a.begin());
-
-            return (end() - n);
-        }
-        int distance = cp - cbegin();
-
-        size_ += n;
-        if (size_ > capacity_) {
-            size_ %= capacity_;
-        }
-
-        iterator p = begin() + distance;
-        iterator i = end() - 1;
-        while (i != p) {
-            T* ptr = &(*i);
-            if (i <= end() - n) {
-                Alloc_traits::destroy(allocator_, ptr);
-            }
-
-            Alloc_traits::construct(allocator_, ptr, *(i - n));
-            --i;
-        }
-
-        for (auto j = i, k = a.begin(); j < i + n; ++j, ++k) {
-            Alloc_traits::construct(allocator_, &(*j), *k);
-        }
-        return i;
+    iterator insert(const_iterator cp, CCircularBuffer<T>&& a) {
+        return insert_buffer(cp, std::move(a));
     }
 
     constexpr iterator erase(const_iterator cp) {
-
-        iterator p = begin() + (cp - cbegin());
-        if (cp == cend() || size_ == 0) {
-            return p;
+        size_t n = cp - cbegin();
+        if (n >= size_) {
+            return end();
         }
-        T* ptr;
-        iterator i = p;
-
-        while (i != end() - 1) {
-            ptr = &*i;
-
-            Alloc_traits::destroy(allocator_, ptr);
-            Alloc_traits::construct(allocator_, ptr, *(i + 1));
-            ++i;
+        for (size_t k = n; k + 1 < size_; ++k) {
+            *slot(k) = std::move(*slot(k + 1));
         }
-        Alloc_traits::destroy(allocator_, &*i);
+        Alloc_traits::destroy(allocator_, slot(size_ - 1));
 
         --size_;
-        return p;
+        return begin() + n;
     }
 
     constexpr iterator erase(const_iterator cq1, const_iterator cq2) {
-
-        iterator q1 = begin() + (cq1 - cbegin());
-        iterator q2 = begin() + (cq2 - cbegin());
-        if (q1 == end() || q1 >= q2 || size_ <= q2 - q1) {
-            return q1;
+        size_t first = cq1 - cbegin();
+        size_t last = cq2 - cbegin();
+        if (first >= last || last > size_) {
+            return begin() + first;
         }
-        T* ptr;
-        iterator i = q1;
-        size_t n = q2 - q1;
-
-        while (i != end() - n) {
-            ptr = &*i;
-
-            Alloc_traits::destroy(allocator_, ptr);
-            Alloc_traits::construct(allocator_, ptr, *(i + n));
-            ++i;
+        size_t n = last - first;
+        for (size_t k = first; k + n < size_; ++k) {
+            *slot(k) = std::move(*slot(k + n));
+        }
+        for (size_t k = size_ - n; k < size_; ++k) {
+            Alloc_traits::destroy(allocator_, slot(k));
         }
-        Alloc_traits::destroy(allocator_, &*i);
 
         size_ -= n;
-        return q1;
+        return begin() + first;
     }
 
     void clear() {
-        for (iterator i = begin(); i != end(); ++i) {
-            Alloc_traits::destroy(allocator_, &(*i));
+        for (size_t k = 0; k < size_; ++k) {
+            Alloc_traits::destroy(allocator_, slot(k));
         }
         size_ = 0;
     }
@@ -449,87 +355,51 @@ public:
 
     constexpr const T& front() const noexcept { return start_in_memory_[head_]; }
 
-    constexpr T& back() noexcept { return start_in_memory_[(head_ + size_ - 1) % capacity_]; }
+    constexpr T& back() noexcept { return *slot(size_ - 1); }
 
-    constexpr const T& back() const noexcept {
-        return start_in_memory_[(head_ + size_) % capacity_];
-    }
+    constexpr const T& back() const noexcept { return *slot(size_ - 1); }
 
     template<typename... Args>
     void emplace_front(Args&& ...args) {
-        push_front(std::forward<Args>(args)...);
-    }
-
-    template<typename... Args>
-    void emplace_back(Args&& ...args) {
-        push_back(std::forward<Args>(args)...);
-    }
-
-    virtual void push_front(const T& value) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
+        if (!ensure_room(1)) {
+            CB_THROW(FullBufferException());
         }
 
-        if (head_ > 0) {
-            --head_;
-        } else {
-            head_ = capacity_ - 1;
-        }
-        Alloc_traits::construct(allocator_, start_in_memory_ + head_, value);
-
+        size_t head = head_ > 0 ? head_ - 1 : capacity_ - 1;
+        Alloc_traits::construct(allocator_, start_in_memory_ + head, std::forward<Args>(args)...);
+        head_ = head;
         ++size_;
-        if (size_ > capacity_)
-            size_ %= capacity_;
     }
 
-    virtual void push_front(T&& value) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
-        }
-
-        if (head_ > 0) {
-            --head_;
-        } else {
-            head_ = capacity_ - 1;
+    template<typename... Args>
+    void emplace_back(Args&& ...args) {
+        if (!ensure_room(1)) {
+            CB_THROW(FullBufferException());
         }
-        Alloc_traits::construct(allocator_, start_in_memory_ + head_,
-                                std::move(value));
 
+        Alloc_traits::construct(allocator_, slot(size_), std::forward<Args>(args)...);
         ++size_;
-        if (size_ > capacity_)
-            size_ %= capacity_;
     }
 
-    virtual void push_back(const T& value) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
-        }
-
-        Alloc_traits::construct(
-                allocator_, start_in_memory_ + ((head_ + size_) % capacity_), value);
-
-        ++size_;
-        if (size_ > capacity_)
-            size_ %= capacity_;
+    void push_front(const T& value) {
+        emplace_front(value);
     }
 
-    virtual void push_back(T&& value) {
-        if (size_ == capacity_) {
-            throw FullBufferException();
-        }
+    void push_front(T&& value) {
+        emplace_front(std::move(value));
+    }
 
-        Alloc_traits::construct(allocator_,
-                                start_in_memory_ + ((head_ + size_) % capacity_),
-                                std::move(value));
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
 
-        ++size_;
-        if (size_ > capacity_)
-            size_ %= capacity_;
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
     }
 
     void pop_front() {
         if (size_ == 0) {
-            throw EmptyBufferException();
+            CB_THROW(EmptyBufferException());
         }
         Alloc_traits::destroy(allocator_, start_in_memory_ + head_);
 
@@ -541,33 +411,234 @@ public:
 
     void pop_back() {
         if (size_ == 0) {
-            throw EmptyBufferException();
+            CB_THROW(EmptyBufferException());
         }
-        Alloc_traits::destroy(allocator_,
-                              start_in_memory_ + (head_ + size_ - 1) % capacity_);
+        Alloc_traits::destroy(allocator_, slot(size_ - 1));
 
         --size_;
     }
 
+    // Non-throwing variants: a full or empty buffer is reported by the return value.
+
+    bool try_push_back(const T& value) {
+        return try_emplace_back(value);
+    }
+
+    bool try_push_back(T&& value) {
+        return try_emplace_back(std::move(value));
+    }
+
+    template<typename... Args>
+    bool try_emplace_back(Args&& ...args) {
+        if (!ensure_room(1)) {
+            return false;
+        }
+        Alloc_traits::construct(allocator_, slot(size_), std::forward<Args>(args)...);
+        ++size_;
+        return true;
+    }
+
+    bool try_pop_front(T& value) {
+        if (size_ == 0) {
+            return false;
+        }
+        value = std::move(start_in_memory_[head_]);
+        pop_front();
+        return true;
+    }
+
+    std::optional<T> try_pop_front() {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(start_in_memory_[head_]));
+        pop_front();
+        return value;
+    }
+
     constexpr T& operator[](size_t n) {
-        return start_in_memory_[head_ + n % capacity_];
+        return *slot(n);
     }
 
     constexpr const T& operator[](size_t n) const {
-        return start_in_memory_[head_ + n % capacity_];
+        return *slot(n);
     }
 
-    constexpr T& at(size_t n) { return start_in_memory_[head_ + n % capacity_]; }
+    constexpr T& at(size_t n) { return *slot(n); }
 
     constexpr const T& at(size_t n) const {
-        return start_in_memory_[head_ + n % capacity_];
+        return *slot(n);
+    }
+
+    // Non-owning view of the elements, a borrowed range: iterators taken from it stay valid
+    // after the view itself is gone, for as long as the buffer is not modified.
+    constexpr std::ranges::subrange<iterator> view() noexcept { return {begin(), end()}; }
+
+    constexpr std::ranges::subrange<const_iterator> view() const noexcept { return {begin(), end()}; }
+
+    // Elements in logical order as at most two contiguous ranges of raw memory;
+    // segments() | std::views::join iterates them with plain pointers.
+    constexpr std::array<std::span<T>, 2> segments() noexcept {
+        return make_segments<T>();
+    }
+
+    constexpr std::array<std::span<const T>, 2> segments() const noexcept {
+        return make_segments<const T>();
+    }
+
+    // Writes the contents through writer(const void* data, size_t size): a CircularBufferHeader,
+    // then for a trivially copyable T the one or two segments with one call each. Other types, or
+    // a custom Serializer, are encoded into blocks of about kserialize_block bytes.
+    template<typename Serializer = TrivialSerializer<T>, typename Writer>
+    void serialize(Writer&& writer) const {
+        constexpr bool raw = is_raw<Serializer>();
+        CircularBufferHeader header{{'C', 'B', 'S', 'B'}, CircularBufferHeader::kversion,
+                                    raw ? uint32_t(sizeof(T)) : 0, serialization_tag<T, Serializer>(), size_,
+                                    capacity_};
+        writer(static_cast<const void*>(&header), sizeof(header));
+        if constexpr (raw) {
+            for (auto part: segments()) {
+                if (!part.empty()) {
+                    writer(static_cast<const void*>(part.data()), part.size_bytes());
+                }
+            }
+        } else {
+            std::vector<std::byte> block;
+            auto flush = [&] {
+                uint64_t length = block.size();
+                writer(static_cast<const void*>(&length), sizeof(length));
+                writer(static_cast<const void*>(block.data()), block.size());
+                block.clear();
+            };
+            for (size_t k = 0; k < size_; ++k) {
+                Serializer::serialize(*slot(k), block);
+                if (block.size() >= kserialize_block) {
+                    flush();
+                }
+            }
+            if (!block.empty()) {
+                flush();
+            }
+        }
+    }
+
+    // Replaces the contents with those written by serialize(), reading through
+    // reader(void* data, size_t size), which must fill all size bytes or throw. The capacity becomes
+    // the serialized one, allocated at most once; raw elements are read with a single call.
+    // Data of another element type, serializer or layout throws std::runtime_error. On an error
+    // the buffer keeps the elements restored so far. The custom Serializer path needs a default
+    // constructible T.
+    template<typename Serializer = TrivialSerializer<T>, typename Reader>
+    void deserialize(Reader&& reader) {
+        constexpr bool raw = is_raw<Serializer>();
+        CircularBufferHeader header{};
+        reader(static_cast<void*>(&header), sizeof(header));
+        if (std::memcmp(header.magic, "CBSB", 4) != 0 || header.version != CircularBufferHeader::kversion ||
+            header.element_size != (raw ? sizeof(T) : 0) ||
+            header.type_tag != serialization_tag<T, Serializer>() || header.size > header.capacity) {
+            CB_THROW(std::runtime_error("not a serialized buffer of this element type"));
+        }
+
+        clear();
+        head_ = 0;
+        if (capacity_ != header.capacity || start_in_memory_ == nullptr) {
+            if (start_in_memory_ != nullptr) {
+                Alloc_traits::deallocate(allocator_, start_in_memory_, capacity_);
+                start_in_memory_ = nullptr;
+                capacity_ = 0;
+            }
+            start_in_memory_ = Alloc_traits::allocate(allocator_, header.capacity);
+            capacity_ = header.capacity;
+        }
+
+        if constexpr (raw) {
+            reader(static_cast<void*>(start_in_memory_), header.size * sizeof(T));
+            size_ = header.size;
+        } else {
+            std::vector<std::byte> block;
+            T value;
+            while (size_ < header.size) {
+                uint64_t length = 0;
+                reader(static_cast<void*>(&length), sizeof(length));
+                if (length == 0) {
+                    CB_THROW(std::runtime_error("corrupt serialized buffer"));
+                }
+                block.resize(length);
+                reader(static_cast<void*>(block.data()), block.size());
+                std::span<const std::byte> data(block);
+                while (!data.empty()) {
+                    size_t used = Serializer::deserialize(data, value);
+                    if (used == 0 || size_ == header.size) {
+                        CB_THROW(std::runtime_error("corrupt serialized buffer"));
+                    }
+                    Alloc_traits::construct(allocator_, start_in_memory_ + size_, std::move(value));
+                    ++size_;
+                    data = data.subspan(used);
+                }
+            }
+        }
     }
 
 protected:
+    // Returns true if n more elements fit. CCircularBufferExt grows the storage here.
+    virtual bool ensure_room(size_t n) {
+        return size_ + n <= capacity_;
+    }
+
+    constexpr T* slot(size_t n) const noexcept {
+        return start_in_memory_ + (head_ + n) % capacity_;
+    }
+
     Alloc allocator_;
     size_t capacity_;
     T* start_in_memory_;
     size_t head_;
     size_t size_;
-};
 
+private:
+    static constexpr size_t kserialize_block = 64 << 10;
+
+    template<typename Serializer>
+    static constexpr bool is_raw() noexcept {
+        return std::is_trivially_copyable_v<T> && std::is_same_v<Serializer, TrivialSerializer<T>>;
+    }
+
+    template<typename U>
+    constexpr std::array<std::span<U>, 2> make_segments() const noexcept {
+        if (head_ + size_ <= capacity_) {
+            return {std::span<U>(start_in_memory_ + head_, size_), std::span<U>()};
+        }
+        return {std::span<U>(start_in_memory_ + head_, capacity_ - head_),
+                std::span<U>(start_in_memory_, head_ + size_ - capacity_)};
+    }
+
+    // Elements of a are copied from an lvalue buffer and moved from an rvalue one.
+    template<typename Buffer>
+    iterator insert_buffer(const_iterator cp, Buffer&& a) {
+        using element = std::conditional_t<std::is_lvalue_reference_v<Buffer>, const T&, T&&>;
+
+        size_t count = a.size();
+        size_t n = cp - cbegin();
+        if (!ensure_room(count)) {
+            CB_THROW(FullBufferException());
+        }
+
+        for (size_t k = size_ + count; k-- > n + count;) {
+            if (k >= size_) {
+                Alloc_traits::construct(allocator_, slot(k), std::move(*slot(k - count)));
+            } else {
+                *slot(k) = std::move(*slot(k - count));
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            if (n + j < size_) {
+                *slot(n + j) = static_cast<element>(a[j]);
+            } else {
+                Alloc_traits::construct(allocator_, slot(n + j), static_cast<element>(a[j]));
+            }
+        }
+
+        size_ += count;
+        return begin() + n;
+    }
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Circular buffer of Bits-wide unsigned values (bool for Bits == 1) packed into 64-bit words.
+// A full buffer overwrites its oldest value. Values are packed back to back, so with a Bits that
+// does not divide 64 (e.g. 3, 5 or 12) some values span two words and take two word accesses.
+template<unsigned Bits = 1>
+class CCircularBufferBits {
+    static_assert(Bits > 0 && Bits <= 64, "Bits must be in [1, 64]");
+
+public:
+    using value_type = std::conditional_t<Bits == 1, bool,
+            std::conditional_t<Bits <= 8, uint8_t,
+                    std::conditional_t<Bits <= 16, uint16_t,
+                            std::conditional_t<Bits <= 32, uint32_t, uint64_t>>>>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Proxy for one packed value.
+    class reference {
+    public:
+        constexpr operator value_type() const noexcept { return static_cast<value_type>(load(words_, bit_)); }
+
+        constexpr reference& operator=(value_type value) noexcept {
+            store(words_, bit_, static_cast<uint64_t>(value));
+            return *this;
+        }
+
+        constexpr reference& operator=(const reference& other) noexcept {
+            return *this = static_cast<value_type>(other);
+        }
+
+    private:
+        friend class CCircularBufferBits;
+
+        constexpr reference(uint64_t* words, size_t bit) noexcept: words_(words), bit_(bit) {}
+
+        uint64_t* words_;
+        size_t bit_;
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = CCircularBufferBits::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;
+        using pointer = void;
+
+        constexpr const_iterator() noexcept = default;
+
+        constexpr value_type operator*() const noexcept { return (*buffer_)[index_]; }
+
+        constexpr value_type operator[](difference_type n) const noexcept { return (*buffer_)[index_ + n]; }
+
+        constexpr const_iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        constexpr const_iterator operator++(int) noexcept { return const_iterator(buffer_, index_++); }
+
+        constexpr const_iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        constexpr const_iterator operator--(int) noexcept { return const_iterator(buffer_, index_--); }
+
+        constexpr const_iterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        constexpr const_iterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        constexpr const_iterator operator+(difference_type n) const noexcept {
+            return const_iterator(buffer_, index_ + n);
+        }
+
+        friend constexpr const_iterator operator+(difference_type n, const const_iterator& i) noexcept {
+            return i + n;
+        }
+
+        constexpr const_iterator operator-(difference_type n) const noexcept {
+            return const_iterator(buffer_, index_ - n);
+        }
+
+        constexpr difference_type operator-(const const_iterator& other) const noexcept {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        constexpr bool operator==(const const_iterator& other) const noexcept { return index_ == other.index_; }
+
+        constexpr auto operator<=>(const const_iterator& other) const noexcept { return index_ <=> other.index_; }
+
+    private:
+        friend class CCircularBufferBits;
+
+        constexpr const_iterator(const CCircularBufferBits* buffer, size_t index) noexcept
+                : buffer_(buffer), index_(index) {}
+
+        const CCircularBufferBits* buffer_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    constexpr CCircularBufferBits() noexcept: capacity_(0), head_(0), size_(0) {}
+
+    explicit CCircularBufferBits(size_t capacity)
+            : words_((capacity * Bits + 63) / 64, 0), capacity_(capacity), head_(0), size_(0) {}
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+    [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] constexpr size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] constexpr bool full() const noexcept { return size_ == capacity_; }
+
+    // Appends value, overwriting the oldest one if the buffer is full.
+    void push_back(value_type value) noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        if (size_ == capacity_) {
+            at_slot(head_) = value;
+            head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+            return;
+        }
+        at_slot((head_ + size_) % capacity_) = value;
+        ++size_;
+    }
+
+    void pop_front() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+        --size_;
+    }
+
+    void clear() noexcept {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    reference operator[](size_t n) noexcept { return at_slot((head_ + n) % capacity_); }
+
+    value_type operator[](size_t n) const noexcept {
+        return const_cast<CCircularBufferBits*>(this)->at_slot((head_ + n) % capacity_);
+    }
+
+    value_type front() const noexcept { return (*this)[0]; }
+
+    value_type back() const noexcept { return (*this)[size_ - 1]; }
+
+    // Number of set values in the buffer, popcount over at most capacity / 64 + 2 words.
+    [[nodiscard]] size_t count() const noexcept requires (Bits == 1) {
+        if (head_ + size_ <= capacity_) {
+            return count_bits(head_, head_ + size_);
+        }
+        return count_bits(head_, capacity_) + count_bits(0, head_ + size_ - capacity_);
+    }
+
+private:
+    static constexpr uint64_t kmask = Bits == 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+
+    reference at_slot(size_t slot) noexcept { return reference(words_.data(), slot * Bits); }
+
+    static constexpr uint64_t load(const uint64_t* words, size_t bit) noexcept {
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+        uint64_t value = words[word] >> shift;
+        if (shift + Bits > 64) {
+            value |= words[word + 1] << (64 - shift);
+        }
+        return value & kmask;
+    }
+
+    static constexpr void store(uint64_t* words, size_t bit, uint64_t value) noexcept {
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+        value &= kmask;
+        words[word] = (words[word] & ~(kmask << shift)) | (value << shift);
+        if (shift + Bits > 64) {
+            unsigned low = 64 - shift; // bits stored in the first word
+            words[word + 1] = (words[word + 1] & ~(kmask >> low)) | (value >> low);
+        }
+    }
+
+    // Set bits among physical positions [first, last).
+    size_t count_bits(size_t first, size_t last) const noexcept {
+        if (first == last) {
+            return 0;
+        }
+        size_t first_word = first / 64;
+        size_t last_word = (last - 1) / 64;
+        uint64_t head_mask = ~uint64_t(0) << (first % 64);
+        uint64_t tail_mask = ~uint64_t(0) >> (63 - (last - 1) % 64);
+        if (first_word == last_word) {
+            return std::popcount(words_[first_word] & head_mask & tail_mask);
+        }
+        size_t n = std::popcount(words_[first_word] & head_mask) + std::popcount(words_[last_word] & tail_mask);
+        for (size_t i = first_word + 1; i < last_word; ++i) {
+            n += std::popcount(words_[i]);
+        }
+        return n;
+    }
+
+    std::vector<uint64_t> words_;
+    size_t capacity_;
+    size_t head_;
+    size_t size_;
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Streaming k-way merge over buffers that are each ordered by comp, e.g. one CCircularBuffer per
+// source sorted by timestamp. Every source is read through its segments() with a plain pointer,
+// and a loser tree picks the next element in O(log k) comparisons. Equal elements come out in
+// source order.
+//
+// With Consume = true the elements are moved out and popped from their source as they are
+// emitted; otherwise they are copied and the sources are left unchanged. The sources must not be
+// modified by anyone else while the merge is in use.
+template<typename Buffer, typename Compare = std::less<>, bool Consume = false>
+class CCircularBufferMerge {
+    using Segment = std::remove_cvref_t<decltype(std::declval<Buffer&>().segments()[0])>;
+    using Pointer = typename Segment::pointer;
+
+public:
+    using value_type = typename Buffer::value_type;
+    using size_type = std::size_t;
+
+    explicit CCircularBufferMerge(std::vector<Buffer*> sources, Compare comp = Compare())
+            : sources_(std::move(sources)), comp_(std::move(comp)), cursors_(sources_.size()),
+              tree_(sources_.size()) {
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            auto segments = sources_[i]->segments();
+            cursors_[i] = Cursor{segments[0].data(), segments[0].data() + segments[0].size(), segments[1]};
+            cursors_[i].skip_empty();
+            remaining_ += segments[0].size() + segments[1].size();
+        }
+        build();
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return remaining_ == 0; }
+
+    // Elements not emitted yet.
+    [[nodiscard]] size_t size() const noexcept { return remaining_; }
+
+    // Next element in merged order. The merge must not be empty.
+    const value_type& top() const noexcept { return *cursors_[tree_[0]].current; }
+
+    // Index of the source top() comes from.
+    [[nodiscard]] size_t source() const noexcept { return tree_[0]; }
+
+    void pop() {
+        if (remaining_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        advance(tree_[0]);
+    }
+
+    // Writes up to n next elements to out and returns how many were written.
+    template<typename OutputIterator>
+    size_t drain_merged(OutputIterator out, size_t n) {
+        size_t written = 0;
+        for (; written < n && remaining_ > 0; ++written) {
+            size_t winner = tree_[0];
+            if constexpr (Consume) {
+                *out = std::move(*cursors_[winner].current);
+            } else {
+                *out = *cursors_[winner].current;
+            }
+            ++out;
+            advance(winner);
+        }
+        return written;
+    }
+
+    template<typename OutputIterator>
+    size_t drain_merged(OutputIterator out) {
+        return drain_merged(out, remaining_);
+    }
+
+private:
+    struct Cursor {
+        Pointer current = nullptr;
+        Pointer end = nullptr;
+        Segment next;
+
+        [[nodiscard]] bool exhausted() const noexcept { return current == end; }
+
+        void skip_empty() noexcept {
+            if (current == end && !next.empty()) {
+                current = next.data();
+                end = next.data() + next.size();
+                next = Segment();
+            }
+        }
+    };
+
+    // Strict order of sources by their current element; exhausted sources go last, ties by index.
+    bool before(size_t a, size_t b) const {
+        if (cursors_[a].exhausted()) {
+            return false;
+        }
+        if (cursors_[b].exhausted()) {
+            return true;
+        }
+        if (comp_(*cursors_[a].current, *cursors_[b].current)) {
+            return true;
+        }
+        if (comp_(*cursors_[b].current, *cursors_[a].current)) {
+            return false;
+        }
+        return a < b;
+    }
+
+    // tree_[0] holds the winner, tree_[node] for node in [1, k) the loser of that match.
+    // Leaf i is node k + i, the parent of node is node / 2.
+    void build() {
+        size_t k = sources_.size();
+        if (k == 0) {
+            return;
+        }
+        std::vector<size_t> winners(2 * k);
+        for (size_t i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (size_t node = k - 1; node >= 1; --node) {
+            size_t left = winners[2 * node];
+            size_t right = winners[2 * node + 1];
+            if (before(left, right)) {
+                winners[node] = left;
+                tree_[node] = right;
+            } else {
+                winners[node] = right;
+                tree_[node] = left;
+            }
+        }
+        tree_[0] = winners[1]; // with k == 1 node 1 is the only leaf
+    }
+
+    void advance(size_t s) {
+        Cursor& cursor = cursors_[s];
+        ++cursor.current;
+        cursor.skip_empty();
+        if constexpr (Consume) {
+            sources_[s]->pop_front();
+        }
+        --remaining_;
+
+        size_t winner = s;
+        for (size_t node = (sources_.size() + s) / 2; node >= 1; node /= 2) {
+            if (before(tree_[node], winner)) {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+    std::vector<Buffer*> sources_;
+    Compare comp_;
+    std::vector<Cursor> cursors_;
+    std::vector<size_t> tree_;
+    size_t remaining_ = 0;
+};
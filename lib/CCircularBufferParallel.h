@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Persistent worker threads for the parallel algorithms below. run(tasks, f) calls f(i) for every
+// i in [0, tasks) on the workers and the calling thread and returns when all calls are done, so
+// a call costs a wakeup instead of thread creation. One run() executes at a time; calls from
+// several threads wait for each other, and f must not call run() on the same pool.
+class ParallelPool {
+public:
+    // concurrency counts the calling thread; 0 uses std::thread::hardware_concurrency().
+    explicit ParallelPool(size_t concurrency = 0) {
+        if (concurrency == 0) {
+            concurrency = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(concurrency - 1);
+        for (size_t i = 1; i < concurrency; ++i) {
+            workers_.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ParallelPool(const ParallelPool&) = delete;
+
+    ParallelPool& operator=(const ParallelPool&) = delete;
+
+    ~ParallelPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker: workers_) {
+            worker.join();
+        }
+    }
+
+    // Pool used by the parallel algorithms.
+    static ParallelPool& shared() {
+        static ParallelPool pool;
+        return pool;
+    }
+
+    [[nodiscard]] size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+    template<typename F>
+    void run(size_t tasks, F&& f) {
+        using Function = std::remove_reference_t<F>;
+        if (tasks <= 1 || workers_.empty()) {
+            for (size_t i = 0; i < tasks; ++i) {
+                f(i);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> serial(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            context_ = const_cast<void*>(static_cast<const void*>(&f));
+            call_ = [](void* context, size_t i) { (*static_cast<Function*>(context))(i); };
+            tasks_ = tasks;
+            next_.store(0, std::memory_order_relaxed);
+            active_ = true;
+            ++generation_;
+        }
+        wake_.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Every index is claimed once the caller's work() returns; busy_ == 0 means none is running.
+        done_.wait(lock, [this] { return busy_ == 0; });
+        active_ = false;
+    }
+
+private:
+    // As with std::execution::par, an exception escaping a task terminates the program.
+    void work() noexcept {
+        for (size_t i; (i = next_.fetch_add(1, std::memory_order_relaxed)) < tasks_;) {
+            call_(context_, i);
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || (active_ && generation_ != seen); });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            ++busy_;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--busy_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stop_ = false;
+    bool active_ = false;
+    uint64_t generation_ = 0;
+    size_t busy_ = 0;
+    void* context_ = nullptr;
+    void (*call_)(void*, size_t) = nullptr;
+    size_t tasks_ = 0;
+    std::atomic<size_t> next_{0};
+};
+
+// Parallel algorithms over the contents of a CCircularBuffer (or anything with segments()).
+// The logical range is split into one chunk per thread and every chunk is mapped to at most two
+// raw memory ranges, so the work runs on plain pointers instead of normal_iterator.
+//
+// threads = 0 uses std::thread::hardware_concurrency(). Inputs smaller than kmin_chunk elements
+// per thread use fewer chunks, down to running on the caller alone. Chunks run on
+// ParallelPool::shared(). As with std::execution::par, an exception escaping a callback
+// terminates the program.
+class ParallelChunks {
+public:
+    static constexpr size_t kmin_chunk = 16384;
+
+    template<typename U>
+    using Segments = std::array<std::span<U>, 2>;
+
+    static size_t count(size_t n, size_t threads) noexcept {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return std::clamp<size_t>(n / kmin_chunk, 1, threads);
+    }
+
+    // Calls f(chunk) for chunk in [0, chunks) on the shared pool.
+    template<typename F>
+    static void run(size_t chunks, F&& f) {
+        ParallelPool::shared().run(chunks, f);
+    }
+
+    // Logical elements [first, last) of segments.
+    template<typename U>
+    static Segments<U> slice(const Segments<U>& segments, size_t first, size_t last) noexcept {
+        size_t split = segments[0].size();
+        Segments<U> result;
+        if (first < split) {
+            result[0] = segments[0].subspan(first, std::min(last, split) - first);
+        }
+        if (last > split) {
+            size_t from = std::max(first, split) - split;
+            result[1] = segments[1].subspan(from, last - split - from);
+        }
+        return result;
+    }
+
+    // Calls f(chunk, first, slice(segments, first, last)) for every chunk in parallel.
+    template<typename U, typename F>
+    static size_t for_each(const Segments<U>& segments, size_t threads, F&& f) {
+        size_t n = segments[0].size() + segments[1].size();
+        size_t chunks = count(n, threads);
+        run(chunks, [&](size_t c) {
+            size_t first = n * c / chunks;
+            size_t last = n * (c + 1) / chunks;
+            f(c, first, slice(segments, first, last));
+        });
+        return chunks;
+    }
+
+    // Sorts [first, last) with one std::sort per chunk and rounds of pairwise merges.
+    template<typename It, typename Compare>
+    static void sort(It first, It last, Compare comp, size_t threads) {
+        size_t n = static_cast<size_t>(last - first);
+        size_t chunks = count(n, threads);
+        run(chunks, [&](size_t c) {
+            std::sort(first + n * c / chunks, first + n * (c + 1) / chunks, comp);
+        });
+        for (size_t width = 1; width < chunks; width *= 2) {
+            size_t merges = (chunks + 2 * width - 1) / (2 * width);
+            run(merges, [&](size_t m) {
+                size_t left = 2 * width * m;
+                size_t middle = std::min(left + width, chunks);
+                size_t right = std::min(left + 2 * width, chunks);
+                if (middle < right) {
+                    std::inplace_merge(first + n * left / chunks, first + n * middle / chunks,
+                                       first + n * right / chunks, comp);
+                }
+            });
+        }
+    }
+};
+
+template<typename Buffer, typename F>
+void parallel_for_each(Buffer& buffer, F f, size_t threads = 0) {
+    ParallelChunks::for_each(buffer.segments(), threads, [&f](size_t, size_t, auto chunk) {
+        for (auto& part: chunk) {
+            std::for_each(part.begin(), part.end(), f);
+        }
+    });
+}
+
+// out[i] = f(buffer[i]); out is a random access iterator to at least size() elements.
+template<typename Buffer, typename RandomIt, typename F>
+RandomIt parallel_transform(const Buffer& buffer, RandomIt out, F f, size_t threads = 0) {
+    ParallelChunks::for_each(buffer.segments(), threads, [&](size_t, size_t first, auto chunk) {
+        RandomIt dest = out + static_cast<std::ptrdiff_t>(first);
+        for (auto& part: chunk) {
+            dest = std::transform(part.begin(), part.end(), dest, f);
+        }
+    });
+    return out + static_cast<std::ptrdiff_t>(buffer.size());
+}
+
+// op must be associative; chunk results are combined in logical order.
+template<typename Buffer, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(const Buffer& buffer, T init, BinaryOp op = BinaryOp(), size_t threads = 0) {
+    auto segments = buffer.segments();
+    size_t n = segments[0].size() + segments[1].size();
+    std::vector<std::optional<T>> partial(ParallelChunks::count(n, threads));
+    ParallelChunks::for_each(segments, threads, [&](size_t c, size_t, auto chunk) {
+        auto first = chunk[0].empty() ? chunk[1] : chunk[0];
+        if (first.empty()) {
+            return;
+        }
+        T sum = std::accumulate(first.begin() + 1, first.end(), T(first.front()), op);
+        if (!chunk[0].empty()) {
+            sum = std::accumulate(chunk[1].begin(), chunk[1].end(), std::move(sum), op);
+        }
+        partial[c] = std::move(sum);
+    });
+    for (auto& value: partial) {
+        if (value) {
+            init = op(std::move(init), std::move(*value));
+        }
+    }
+    return init;
+}
+
+// Sorts the logical contents. A wrapped buffer is sorted through a temporary vector,
+// a contiguous one in place.
+template<typename Buffer, typename Compare = std::less<>>
+void parallel_sort(Buffer& buffer, Compare comp = Compare(), size_t threads = 0) {
+    auto segments = buffer.segments();
+    if (segments[1].empty()) {
+        ParallelChunks::sort(segments[0].begin(), segments[0].end(), comp, threads);
+        return;
+    }
+    using T = typename Buffer::value_type;
+    std::vector<T> values(std::make_move_iterator(segments[0].begin()), std::make_move_iterator(segments[0].end()));
+    values.insert(values.end(), std::make_move_iterator(segments[1].begin()),
+                  std::make_move_iterator(segments[1].end()));
+    ParallelChunks::sort(values.begin(), values.end(), comp, threads);
+    auto split = values.begin() + static_cast<std::ptrdiff_t>(segments[0].size());
+    std::move(values.begin(), split, segments[0].begin());
+    std::move(split, values.end(), segments[1].begin());
+}
+
+// Logical index of the first element satisfying pred, or size() if there is none.
+// Chunks past an already found match stop early.
+template<typename Buffer, typename Predicate>
+size_t parallel_find_if(const Buffer& buffer, Predicate pred, size_t threads = 0) {
+    std::atomic<size_t> found{buffer.size()};
+    ParallelChunks::for_each(buffer.segments(), threads, [&](size_t, size_t first, auto chunk) {
+        size_t index = first;
+        for (auto& part: chunk) {
+            for (const auto& value: part) {
+                if (index >= found.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                if (pred(value)) {
+                    size_t current = found.load(std::memory_order_relaxed);
+                    while (index < current && !found.compare_exchange_weak(current, index)) {}
+                    return;
+                }
+                ++index;
+            }
+        }
+    });
+    return found.load();
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Default element serializer of CCircularBuffer::serialize and CSpillingQueue: the raw bytes of
+// a trivially copyable T. A custom serializer provides the same two static functions.
+template<typename T>
+struct TrivialSerializer {
+    static_assert(std::is_trivially_copyable_v<T>, "use a custom serializer for this type");
+
+    // Appends value to out.
+    static void serialize(const T& value, std::vector<std::byte>& out) {
+        auto bytes = std::as_bytes(std::span<const T, 1>(&value, 1));
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    // Decodes one value from the front of data. Returns the bytes used, 0 if data is too short.
+    static size_t deserialize(std::span<const std::byte> data, T& out) {
+        if (data.size() < sizeof(T)) {
+            return 0;
+        }
+        std::memcpy(&out, data.data(), sizeof(T));
+        return sizeof(T);
+    }
+};
+
+// Tag of an element type and its serializer: 32-bit FNV-1a of the compiler's name for this
+// function. Stable between builds of one compiler, not across compilers.
+template<typename T, typename Serializer>
+constexpr uint32_t serialization_tag() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view name = __FUNCSIG__;
+#else
+    std::string_view name = __PRETTY_FUNCTION__;
+#endif
+    uint32_t hash = 2166136261u;
+    for (char c: name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// Serialized buffer layout: this header, then either size elements of element_size raw bytes
+// in logical order, or (element_size == 0) blocks of a uint64_t byte length followed by elements
+// encoded by the serializer. Integers are in host byte order. type_tag is serialization_tag() of
+// the element type and serializer, so a stream is only read back as the same type (e.g. not a
+// float stream into ints) with the same serializer.
+struct CircularBufferHeader {
+    static constexpr uint32_t kversion = 2;
+
+    char magic[4];
+    uint32_t version;
+    uint32_t element_size;
+    uint32_t type_tag;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+static_assert(sizeof(CircularBufferHeader) == 32);
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Set of per-thread circular buffers. Every producer thread appends to its own shard under that
+// shard's mutex, a collector drains all shards. Not lock-free: the mutex is uncontended except
+// while drain_all() or for_each_shard() visits the shard. A full shard overwrites its oldest element.
+template<typename T, typename Alloc = std::allocator<T>>
+class CCircularBufferSharded {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using buffer_type = CCircularBuffer<T, Alloc>;
+
+    explicit CCircularBufferSharded(size_t shard_capacity)
+            : id_(next_id_.fetch_add(1, std::memory_order_relaxed)), shard_capacity_(checked(shard_capacity)) {}
+
+    CCircularBufferSharded(const CCircularBufferSharded&) = delete;
+
+    CCircularBufferSharded& operator=(const CCircularBufferSharded&) = delete;
+
+    ~CCircularBufferSharded() {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (auto& shard: shards_) {
+            shard->detached.store(true, std::memory_order_release);
+        }
+    }
+
+    void push_back(const T& value) {
+        Shard& shard = local_shard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        make_room(shard);
+        shard.buffer.push_back(value);
+    }
+
+    void push_back(T&& value) {
+        Shard& shard = local_shard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        make_room(shard);
+        shard.buffer.push_back(std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace_back(Args&& ...args) {
+        Shard& shard = local_shard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        make_room(shard);
+        shard.buffer.emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Calls f(const buffer_type&) for every shard while that shard is locked.
+    template<typename F>
+    void for_each_shard(F f) const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (auto& shard: shards_) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            f(static_cast<const buffer_type&>(shard->buffer));
+        }
+    }
+
+    // Moves every element to out shard by shard. Returns number of moved elements.
+    template<typename OutputIterator>
+    size_t drain_all(OutputIterator out) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        size_t n = 0;
+        for (auto& shard: shards_) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            n += shard->buffer.size();
+            while (!shard->buffer.empty()) {
+                *out = std::move(shard->buffer.front());
+                ++out;
+                shard->buffer.pop_front();
+            }
+        }
+        remove_exited_shards();
+        return n;
+    }
+
+    // Moves every element to out merged by comp. Each shard must already be ordered by comp,
+    // e.g. by timestamp or sequence number.
+    template<typename OutputIterator, typename Compare>
+    size_t drain_all(OutputIterator out, Compare comp) {
+        std::vector<std::vector<T>> runs;
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            runs.reserve(shards_.size());
+            for (auto& shard: shards_) {
+                std::lock_guard<std::mutex> shard_lock(shard->mutex);
+                std::vector<T> run;
+                run.reserve(shard->buffer.size());
+                while (!shard->buffer.empty()) {
+                    run.push_back(std::move(shard->buffer.front()));
+                    shard->buffer.pop_front();
+                }
+                if (!run.empty()) {
+                    runs.push_back(std::move(run));
+                }
+            }
+            remove_exited_shards();
+        }
+
+        using Cursor = std::pair<size_t, size_t>; // run, position
+        auto greater = [&runs, &comp](const Cursor& a, const Cursor& b) {
+            return comp(runs[b.first][b.second], runs[a.first][a.second]);
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+        for (size_t i = 0; i < runs.size(); ++i) {
+            heap.emplace(i, 0);
+        }
+
+        size_t n = 0;
+        while (!heap.empty()) {
+            Cursor c = heap.top();
+            heap.pop();
+            *out = std::move(runs[c.first][c.second]);
+            ++out;
+            ++n;
+            if (++c.second < runs[c.first].size()) {
+                heap.push(c);
+            }
+        }
+        return n;
+    }
+
+    [[nodiscard]] size_t shard_count() const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        return shards_.size();
+    }
+
+    [[nodiscard]] constexpr size_t shard_capacity() const noexcept { return shard_capacity_; }
+
+    // Number of elements overwritten in full shards since construction.
+    [[nodiscard]] size_t dropped() const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        size_t n = exited_dropped_;
+        for (auto& shard: shards_) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            n += shard->dropped;
+        }
+        return n;
+    }
+
+private:
+    // An empty shard has no oldest element to overwrite.
+    static size_t checked(size_t shard_capacity) {
+        if (shard_capacity == 0) {
+            CB_THROW(std::invalid_argument("CCircularBufferSharded shard capacity must be positive"));
+        }
+        return shard_capacity;
+    }
+
+    struct Shard {
+        explicit Shard(size_t capacity) : buffer(capacity) {}
+
+        std::mutex mutex;
+        buffer_type buffer;
+        size_t dropped = 0;
+        std::atomic<bool> exited{false};
+        std::atomic<bool> detached{false};
+    };
+
+    struct LocalShards {
+        std::vector<std::pair<uint64_t, std::shared_ptr<Shard>>> entries;
+
+        ~LocalShards() {
+            for (auto& entry: entries) {
+                entry.second->exited.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    Shard& local_shard() {
+        for (auto& entry: local_.entries) {
+            if (entry.first == id_) {
+                return *entry.second;
+            }
+        }
+        return register_shard();
+    }
+
+    Shard& register_shard() {
+        std::erase_if(local_.entries, [](const auto& entry) {
+            return entry.second->detached.load(std::memory_order_acquire);
+        });
+
+        auto shard = std::make_shared<Shard>(shard_capacity_);
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            shards_.push_back(shard);
+        }
+        local_.entries.emplace_back(id_, shard);
+        return *shard;
+    }
+
+    void make_room(Shard& shard) {
+        if (shard.buffer.size() == shard.buffer.capacity()) {
+            shard.buffer.pop_front();
+            ++shard.dropped;
+        }
+    }
+
+    // Requires registry_mutex_. Shards of exited threads are released once drained.
+    void remove_exited_shards() {
+        std::erase_if(shards_, [this](const std::shared_ptr<Shard>& shard) {
+            if (shard->exited.load(std::memory_order_acquire) && shard->buffer.empty()) {
+                exited_dropped_ += shard->dropped;
+                return true;
+            }
+            return false;
+        });
+    }
+
+    static inline std::atomic<uint64_t> next_id_{0};
+    static inline thread_local LocalShards local_;
+
+    const uint64_t id_;
+    const size_t shard_capacity_;
+    mutable std::mutex registry_mutex_;
+    std::vector<std::shared_ptr<Shard>> shards_;
+    size_t exited_dropped_ = 0;
+};
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <array>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "CCircularBuffer.h"
+
+// Proxy reference to one logical record of CCircularBufferSoA: one reference per column.
+template<typename... Fields>
+class soa_reference {
+public:
+    using value_type = std::tuple<std::remove_const_t<Fields>...>;
+
+    constexpr explicit soa_reference(Fields& ... fields) noexcept: fields_(fields...) {}
+
+    constexpr soa_reference(const soa_reference& other) noexcept = default;
+
+    constexpr operator value_type() const { return value_type(fields_); }
+
+    constexpr const soa_reference& operator=(const soa_reference& other) const {
+        assign(other.fields_, std::index_sequence_for<Fields...>());
+        return *this;
+    }
+
+    constexpr const soa_reference& operator=(const value_type& value) const {
+        assign(value, std::index_sequence_for<Fields...>());
+        return *this;
+    }
+
+    constexpr const soa_reference& operator=(value_type&& value) const {
+        assign(std::move(value), std::index_sequence_for<Fields...>());
+        return *this;
+    }
+
+    template<size_t I>
+    constexpr auto& get() const noexcept { return std::get<I>(fields_); }
+
+    template<size_t I>
+    friend constexpr auto& get(const soa_reference& r) noexcept { return r.template get<I>(); }
+
+    friend constexpr void swap(soa_reference a, soa_reference b) {
+        a.swap_fields(b, std::index_sequence_for<Fields...>());
+    }
+
+    friend constexpr bool operator==(const soa_reference& a, const soa_reference& b) {
+        return a.fields_ == b.fields_;
+    }
+
+private:
+    template<typename Tuple, size_t... I>
+    constexpr void assign(Tuple&& t, std::index_sequence<I...>) const {
+        ((std::get<I>(fields_) = std::get<I>(std::forward<Tuple>(t))), ...);
+    }
+
+    template<size_t... I>
+    constexpr void swap_fields(const soa_reference& other, std::index_sequence<I...>) const {
+        using std::swap;
+        (swap(std::get<I>(fields_), std::get<I>(other.fields_)), ...);
+    }
+
+    std::tuple<Fields& ...> fields_;
+};
+
+template<typename... Fields, template<typename> typename TQual, template<typename> typename UQual>
+struct std::basic_common_reference<soa_reference<Fields...>,
+        std::tuple<std::remove_const_t<Fields>...>, TQual, UQual> {
+    using type = std::tuple<std::remove_const_t<Fields>...>;
+};
+
+template<typename... Fields, template<typename> typename TQual, template<typename> typename UQual>
+struct std::basic_common_reference<std::tuple<std::remove_const_t<Fields>...>,
+        soa_reference<Fields...>, TQual, UQual> {
+    using type = std::tuple<std::remove_const_t<Fields>...>;
+};
+
+// Random access iterator over CCircularBufferSoA, dereferences to soa_reference.
+template<typename Buffer, typename Reference>
+class soa_iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = typename Reference::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = Reference;
+    using pointer = void;
+    using size_type = size_t;
+
+    constexpr soa_iterator() noexcept = default;
+
+    constexpr soa_iterator(Buffer* buffer, size_type index) noexcept: buffer_(buffer), index_(index) {}
+
+    constexpr reference operator*() const { return (*buffer_)[index_]; }
+
+    constexpr reference operator[](difference_type n) const { return (*buffer_)[index_ + n]; }
+
+    constexpr soa_iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    constexpr soa_iterator operator++(int) noexcept {
+        soa_iterator tmp = *this;
+        ++index_;
+        return tmp;
+    }
+
+    constexpr soa_iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    constexpr soa_iterator operator--(int) noexcept {
+        soa_iterator tmp = *this;
+        --index_;
+        return tmp;
+    }
+
+    constexpr soa_iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    constexpr soa_iterator& operator-=(difference_type n) noexcept {
+        index_ -= n;
+        return *this;
+    }
+
+    constexpr soa_iterator operator+(difference_type n) const noexcept { return soa_iterator(buffer_, index_ + n); }
+
+    friend constexpr soa_iterator operator+(difference_type n, const soa_iterator& i) noexcept { return i + n; }
+
+    constexpr soa_iterator operator-(difference_type n) const noexcept { return soa_iterator(buffer_, index_ - n); }
+
+    constexpr difference_type operator-(const soa_iterator& other) const noexcept {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    constexpr bool operator==(const soa_iterator& other) const noexcept { return index_ == other.index_; }
+
+    constexpr auto operator<=>(const soa_iterator& other) const noexcept { return index_ <=> other.index_; }
+
+private:
+    Buffer* buffer_ = nullptr;
+    size_type index_ = 0;
+};
+
+// Circular buffer of records stored as struct of arrays:
+// one column per field, shared head, size and capacity.
+template<typename... Fields>
+class CCircularBufferSoA {
+    static_assert(sizeof...(Fields) > 0, "CCircularBufferSoA needs at least one field");
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = soa_reference<Fields...>;
+    using const_reference = soa_reference<const Fields...>;
+    using iterator = soa_iterator<CCircularBufferSoA, reference>;
+    using const_iterator = soa_iterator<const CCircularBufferSoA, const_reference>;
+    using difference_type = std::ptrdiff_t;
+    using size_type = std::size_t;
+
+    template<size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    constexpr CCircularBufferSoA() noexcept: columns_(), capacity_(0), head_(0), size_(0) {}
+
+    explicit CCircularBufferSoA(size_t capacity) : columns_(), capacity_(capacity), head_(0), size_(0) {
+        allocate_columns(std::index_sequence_for<Fields...>());
+    }
+
+    CCircularBufferSoA(const CCircularBufferSoA& other) : CCircularBufferSoA(other.capacity_) {
+        for (size_t i = 0; i < other.size_; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    CCircularBufferSoA(CCircularBufferSoA&& other) noexcept: CCircularBufferSoA() {
+        swap(other);
+    }
+
+    ~CCircularBufferSoA() {
+        clear();
+        deallocate_columns(std::index_sequence_for<Fields...>());
+    }
+
+    CCircularBufferSoA& operator=(const CCircularBufferSoA& other) {
+        if (this != &other) {
+            CCircularBufferSoA copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    CCircularBufferSoA& operator=(CCircularBufferSoA&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    constexpr iterator begin() noexcept { return iterator(this, 0); }
+
+    constexpr const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    constexpr iterator end() noexcept { return iterator(this, size_); }
+
+    constexpr const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+
+    constexpr const_iterator cend() const noexcept { return end(); }
+
+    void swap(CCircularBufferSoA& other) noexcept {
+        std::swap(columns_, other.columns_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    friend void swap(CCircularBufferSoA& a, CCircularBufferSoA& b) noexcept { a.swap(b); }
+
+    [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] constexpr size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] constexpr bool full() const noexcept { return size_ == capacity_; }
+
+    void push_back(const Fields& ... fields) {
+        if (size_ == capacity_) {
+            CB_THROW(FullBufferException());
+        }
+        construct_record((head_ + size_) % capacity_, std::index_sequence_for<Fields...>(), fields...);
+        ++size_;
+    }
+
+    void push_back(const value_type& value) {
+        std::apply([this](const Fields& ... fields) { push_back(fields...); }, value);
+    }
+
+    void push_front(const Fields& ... fields) {
+        if (size_ == capacity_) {
+            CB_THROW(FullBufferException());
+        }
+        size_t index = head_ > 0 ? head_ - 1 : capacity_ - 1;
+        construct_record(index, std::index_sequence_for<Fields...>(), fields...);
+        head_ = index;
+        ++size_;
+    }
+
+    void push_front(const value_type& value) {
+        std::apply([this](const Fields& ... fields) { push_front(fields...); }, value);
+    }
+
+    void pop_front() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        destroy_record(head_, std::index_sequence_for<Fields...>());
+        ++head_;
+        head_ %= capacity_;
+        --size_;
+    }
+
+    void pop_back() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        destroy_record((head_ + size_ - 1) % capacity_, std::index_sequence_for<Fields...>());
+        --size_;
+    }
+
+    void clear() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            destroy_record((head_ + i) % capacity_, std::index_sequence_for<Fields...>());
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+    constexpr reference operator[](size_t n) noexcept {
+        return make_reference<reference>(physical(n), std::index_sequence_for<Fields...>());
+    }
+
+    constexpr const_reference operator[](size_t n) const noexcept {
+        return make_reference<const_reference>(physical(n), std::index_sequence_for<Fields...>());
+    }
+
+    constexpr reference front() noexcept { return (*this)[0]; }
+
+    constexpr const_reference front() const noexcept { return (*this)[0]; }
+
+    constexpr reference back() noexcept { return (*this)[size_ - 1]; }
+
+    constexpr const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+    template<size_t I>
+    constexpr column_type<I>& get(size_t n) noexcept { return std::get<I>(columns_)[physical(n)]; }
+
+    template<size_t I>
+    constexpr const column_type<I>& get(size_t n) const noexcept { return std::get<I>(columns_)[physical(n)]; }
+
+    // Column I as at most two contiguous spans in logical order.
+    template<size_t I>
+    constexpr std::array<std::span<column_type<I>>, 2> column_segments() noexcept {
+        return make_segments(std::get<I>(columns_));
+    }
+
+    template<size_t I>
+    constexpr std::array<std::span<const column_type<I>>, 2> column_segments() const noexcept {
+        return make_segments<const column_type<I>>(std::get<I>(columns_));
+    }
+
+private:
+    constexpr size_t physical(size_t n) const noexcept {
+        size_t index = head_ + n;
+        return index < capacity_ ? index : index - capacity_;
+    }
+
+    template<typename U>
+    constexpr std::array<std::span<U>, 2> make_segments(U* column) const noexcept {
+        if (head_ + size_ <= capacity_) {
+            return {std::span<U>(column + head_, size_), std::span<U>()};
+        }
+        return {std::span<U>(column + head_, capacity_ - head_),
+                std::span<U>(column, head_ + size_ - capacity_)};
+    }
+
+    template<typename Ref, size_t... I>
+    constexpr Ref make_reference(size_t index, std::index_sequence<I...>) const noexcept {
+        return Ref(std::get<I>(columns_)[index]...);
+    }
+
+    // Runs undo on scope exit unless release() was called; lets the column folds below
+    // roll back the columns already handled when a later one throws.
+    template<typename F>
+    class rollback {
+    public:
+        explicit rollback(F undo) noexcept: undo_(std::move(undo)) {}
+
+        rollback(const rollback&) = delete;
+
+        rollback& operator=(const rollback&) = delete;
+
+        ~rollback() {
+            if (!released_) {
+                undo_();
+            }
+        }
+
+        void release() noexcept { released_ = true; }
+
+    private:
+        F undo_;
+        bool released_ = false;
+    };
+
+    // Columns not allocated yet are still null and skipped by deallocate_columns.
+    template<size_t... I>
+    void allocate_columns(std::index_sequence<I...> columns) {
+        rollback guard([this, columns] { deallocate_columns(columns); });
+        ((std::get<I>(columns_) = std::allocator<column_type<I>>().allocate(capacity_)), ...);
+        guard.release();
+    }
+
+    template<size_t... I>
+    void deallocate_columns(std::index_sequence<I...>) noexcept {
+        ((std::get<I>(columns_) != nullptr
+          ? std::allocator<column_type<I>>().deallocate(std::get<I>(columns_), capacity_)
+          : void()), ...);
+    }
+
+    template<size_t... I>
+    void construct_record(size_t index, std::index_sequence<I...>, const Fields& ... fields) {
+        size_t constructed = 0;
+        rollback guard([this, index, &constructed] {
+            ((I < constructed ? std::destroy_at(std::get<I>(columns_) + index) : void()), ...);
+        });
+        ((std::construct_at(std::get<I>(columns_) + index, fields), ++constructed), ...);
+        guard.release();
+    }
+
+    template<size_t... I>
+    void destroy_record(size_t index, std::index_sequence<I...>) noexcept {
+        (std::destroy_at(std::get<I>(columns_) + index), ...);
+    }
+
+    std::tuple<Fields* ...> columns_;
+    size_t capacity_;
+    size_t head_;
+    size_t size_;
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+#include "CCircularBuffer.h"
+
+// Byte ring of variable length records. Every record is an 8-byte header followed by its payload,
+// both 8-byte aligned and contiguous in memory. When a record does not fit before the end of the
+// ring the remaining bytes are marked as padding and the record starts at offset 0.
+//
+// Writers call reserve(len), fill the returned span and commit(). Readers use front_record()
+// and pop_record().
+template<typename Alloc = std::allocator<std::byte>>
+class CCircularRecordBuffer {
+public:
+    using size_type = std::size_t;
+    using Alloc_traits = std::allocator_traits<Alloc>;
+
+    static constexpr size_t kalignment = 8;
+
+    explicit CCircularRecordBuffer(size_t capacity, const Alloc& allocator = Alloc())
+            : allocator_(allocator), capacity_(align(capacity)),
+              start_in_memory_(Alloc_traits::allocate(allocator_, capacity_)) {}
+
+    CCircularRecordBuffer(const CCircularRecordBuffer&) = delete;
+
+    CCircularRecordBuffer& operator=(const CCircularRecordBuffer&) = delete;
+
+    ~CCircularRecordBuffer() {
+        Alloc_traits::deallocate(allocator_, start_in_memory_, capacity_);
+    }
+
+    // Contiguous space for a record of len bytes, or an empty span if it does not fit now.
+    // The record becomes visible to readers on commit(). A new reserve() drops an uncommitted one,
+    // also when it fails.
+    std::span<std::byte> reserve(size_t len) {
+        reserved_ = false;
+        size_t need = sizeof(Header) + align(len);
+        if (used_ == 0) {
+            head_ = 0;
+            tail_ = 0;
+        }
+
+        size_t offset = tail_;
+        size_t padding = 0;
+        if (tail_ >= head_ && used_ < capacity_) {
+            if (need > capacity_ - tail_) {
+                if (need > head_) {
+                    return {};
+                }
+                padding = capacity_ - tail_;
+                offset = 0;
+            }
+        } else if (need > capacity_ - used_) {
+            return {};
+        }
+
+        reserved_offset_ = offset;
+        reserved_length_ = len;
+        reserved_padding_ = padding;
+        reserved_ = true;
+        return {start_in_memory_ + offset + sizeof(Header), len};
+    }
+
+    // Publishes the reserved record, optionally shortened to len bytes.
+    void commit() {
+        commit(reserved_length_);
+    }
+
+    void commit(size_t len) {
+        if (!reserved_ || len > reserved_length_) {
+            return;
+        }
+        if (reserved_padding_ > 0) {
+            write_header(tail_, static_cast<uint32_t>(reserved_padding_ - sizeof(Header)), kskip);
+        }
+        write_header(reserved_offset_, static_cast<uint32_t>(len), krecord);
+
+        size_t record = sizeof(Header) + align(len);
+        tail_ = reserved_offset_ + record;
+        if (tail_ == capacity_) {
+            tail_ = 0;
+        }
+        used_ += reserved_padding_ + record;
+        ++size_;
+        reserved_ = false;
+    }
+
+    // Copies data into a new record. Returns false if there is no room.
+    bool push(std::span<const std::byte> data) {
+        std::span<std::byte> record = reserve(data.size());
+        if (record.data() == nullptr) {
+            return false;
+        }
+        std::memcpy(record.data(), data.data(), data.size());
+        commit();
+        return true;
+    }
+
+    // Payload of the oldest record. The buffer must not be empty.
+    [[nodiscard]] std::span<const std::byte> front_record() const noexcept {
+        size_t offset = skip_padding(head_);
+        return {start_in_memory_ + offset + sizeof(Header), read_header(offset).length};
+    }
+
+    void pop_record() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        size_t offset = skip_padding(head_);
+        size_t record = sizeof(Header) + align(read_header(offset).length);
+        used_ -= (offset >= head_ ? offset - head_ : capacity_ - head_ + offset) + record;
+        head_ = offset + record;
+        if (head_ == capacity_) {
+            head_ = 0;
+        }
+        --size_;
+    }
+
+    // Number of committed records.
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    // Bytes taken by headers, payloads and padding.
+    [[nodiscard]] size_t bytes_used() const noexcept { return used_; }
+
+private:
+    struct Header {
+        uint32_t length;
+        uint32_t kind;
+    };
+
+    static constexpr uint32_t krecord = 0;
+    static constexpr uint32_t kskip = 1;
+
+    static constexpr size_t align(size_t n) noexcept {
+        return (n + kalignment - 1) / kalignment * kalignment;
+    }
+
+    Header read_header(size_t offset) const noexcept {
+        Header header{};
+        std::memcpy(&header, start_in_memory_ + offset, sizeof(Header));
+        return header;
+    }
+
+    void write_header(size_t offset, uint32_t length, uint32_t kind) noexcept {
+        Header header{length, kind};
+        std::memcpy(start_in_memory_ + offset, &header, sizeof(Header));
+    }
+
+    size_t skip_padding(size_t offset) const noexcept {
+        if (read_header(offset).kind == kskip) {
+            return 0;
+        }
+        return offset;
+    }
+
+    Alloc allocator_;
+    size_t capacity_;
+    std::byte* start_in_memory_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+    size_t used_ = 0;
+    size_t size_ = 0;
+
+    size_t reserved_offset_ = 0;
+    size_t reserved_length_ = 0;
+    size_t reserved_padding_ = 0;
+    bool reserved_ = false;
+};
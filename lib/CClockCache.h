@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "CCircularBuffer.h"
+#include "CLinearProbingTable.h"
+
+// Fixed-size cache with CLOCK (second chance) eviction. Entries live in a ring of slots,
+// a hit only sets the reference bit of its slot, the hand clears bits until it finds a victim.
+// Keys are found through an open-addressing (linear probing) index of slot numbers.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class CClockCache {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using size_type = std::size_t;
+
+    explicit CClockCache(size_t capacity, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : slots_(checked(capacity)), referenced_(capacity, 0), index_(capacity, kempty), hand_(0), hash_(hash),
+              equal_(equal) {}
+
+    // Returns the cached value or nullptr. A hit marks the slot as recently used.
+    Value* find(const Key& key) {
+        size_t position = find_position(key);
+        if (!index_.occupied(position)) {
+            return nullptr;
+        }
+        uint32_t slot = index_[position];
+        referenced_[slot] = 1;
+        return &slots_[slot].value;
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const {
+        return index_.occupied(find_position(key));
+    }
+
+    // Inserts or replaces the value of key, evicting an entry if the cache is full.
+    // Returns a reference to the stored value.
+    template<typename V>
+    Value& put(const Key& key, V&& value) {
+        size_t position = find_position(key);
+        if (index_.occupied(position)) {
+            uint32_t slot = index_[position];
+            slots_[slot].value = std::forward<V>(value);
+            referenced_[slot] = 1;
+            return slots_[slot].value;
+        }
+
+        uint32_t slot;
+        if (slots_.size() < slots_.capacity()) {
+            slot = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back(key, std::forward<V>(value));
+        } else {
+            slot = evict();
+            slots_[slot].key = key;
+            slots_[slot].value = std::forward<V>(value);
+            position = find_position(key);
+        }
+        referenced_[slot] = 0;
+        index_[position] = slot;
+        return slots_[slot].value;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return slots_.size(); }
+
+    [[nodiscard]] size_t capacity() const noexcept { return slots_.capacity(); }
+
+    [[nodiscard]] bool empty() const noexcept { return slots_.empty(); }
+
+private:
+    struct Entry {
+        Entry(const Key& k, Value v) : key(k), value(std::move(v)) {}
+
+        Key key;
+        Value value;
+    };
+
+    static constexpr uint32_t kempty = UINT32_MAX;
+
+    // Slot numbers are stored as uint32_t with kempty reserved, and eviction needs a slot.
+    static size_t checked(size_t capacity) {
+        if (capacity == 0) {
+            CB_THROW(std::invalid_argument("CClockCache capacity must be positive"));
+        }
+        if (capacity >= kempty) {
+            CB_THROW(std::length_error("CClockCache capacity exceeds its slot index type"));
+        }
+        return capacity;
+    }
+
+    struct EmptySlot {
+        bool operator()(uint32_t slot) const noexcept { return slot == kempty; }
+    };
+
+    // Position of key in the index or the empty position where it would be inserted.
+    size_t find_position(const Key& key) const {
+        return index_.find(hash_(key), [&](uint32_t slot) { return equal_(slots_[slot].key, key); });
+    }
+
+    // Advances the hand to the first slot with a cleared reference bit and unlinks its key.
+    uint32_t evict() {
+        while (referenced_[hand_]) {
+            referenced_[hand_] = 0;
+            hand_ = (hand_ + 1) % slots_.capacity();
+        }
+        auto victim = static_cast<uint32_t>(hand_);
+        hand_ = (hand_ + 1) % slots_.capacity();
+        index_.erase(find_position(slots_[victim].key), [this](uint32_t slot) { return hash_(slots_[slot].key); });
+        return victim;
+    }
+
+    CCircularBuffer<Entry> slots_;
+    std::vector<uint8_t> referenced_;
+    CLinearProbingTable<uint32_t, EmptySlot> index_;
+    size_t hand_;
+    Hash hash_;
+    KeyEqual equal_;
+};
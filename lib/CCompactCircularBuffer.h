@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "CCircularBuffer.h"
+
+// Fixed-capacity ring for holding millions of small instances: no vtable, the allocator takes no
+// space when it is stateless, and capacity, head and size are stored as Index.
+// With the default allocator the object is 24 bytes for uint32_t and 16 bytes for uint16_t or
+// uint8_t indices. The capacity must not exceed the largest Index value; index arithmetic is
+// done in size_t, so it stays correct up to that limit.
+template<typename T, typename Index = uint32_t, typename Alloc = std::allocator<T>>
+class CCompactCircularBuffer {
+    static_assert(std::is_unsigned_v<Index> && !std::is_same_v<Index, bool>, "Index must be an unsigned integer type");
+
+public:
+    using iterator = normal_iterator<T>;
+    using const_iterator = normal_iterator<const T>;
+
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using size_type = std::size_t;
+    using index_type = Index;
+
+    using Alloc_traits = std::allocator_traits<Alloc>;
+
+    static constexpr size_t kmax_capacity = std::numeric_limits<Index>::max();
+
+    constexpr CCompactCircularBuffer() noexcept = default;
+
+    explicit CCompactCircularBuffer(size_t capacity, const Alloc& allocator = Alloc())
+            : allocator_(allocator), start_in_memory_(nullptr), capacity_(checked(capacity)) {
+        if (capacity_ > 0) {
+            start_in_memory_ = Alloc_traits::allocate(allocator_, capacity_);
+        }
+    }
+
+    CCompactCircularBuffer(const CCompactCircularBuffer& other)
+            : CCompactCircularBuffer(other.capacity_,
+                                     Alloc_traits::select_on_container_copy_construction(other.allocator_)) {
+        for (size_t k = 0; k < other.size_; ++k) {
+            Alloc_traits::construct(allocator_, slot(k), *other.slot(k));
+            ++size_;
+        }
+    }
+
+    CCompactCircularBuffer(CCompactCircularBuffer&& other) noexcept
+            : allocator_(std::move(other.allocator_)),
+              start_in_memory_(std::exchange(other.start_in_memory_, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)), head_(std::exchange(other.head_, 0)),
+              size_(std::exchange(other.size_, 0)) {}
+
+    CCompactCircularBuffer& operator=(const CCompactCircularBuffer& other) {
+        if (this != &other) {
+            CCompactCircularBuffer copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    CCompactCircularBuffer& operator=(CCompactCircularBuffer&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~CCompactCircularBuffer() {
+        if (start_in_memory_ == nullptr) {
+            return;
+        }
+        clear();
+        Alloc_traits::deallocate(allocator_, start_in_memory_, capacity_);
+    }
+
+    constexpr iterator begin() noexcept {
+        return iterator(start_in_memory_, capacity_, head_, 0);
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return const_iterator(start_in_memory_, capacity_, head_, 0);
+    }
+
+    constexpr iterator end() noexcept {
+        return iterator(start_in_memory_, capacity_, head_, size_);
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return const_iterator(start_in_memory_, capacity_, head_, size_);
+    }
+
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+
+    constexpr const_iterator cend() const noexcept { return end(); }
+
+    void swap(CCompactCircularBuffer& other) noexcept {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+        swap(start_in_memory_, other.start_in_memory_);
+        swap(capacity_, other.capacity_);
+        swap(head_, other.head_);
+        swap(size_, other.size_);
+    }
+
+    friend void swap(CCompactCircularBuffer& a, CCompactCircularBuffer& b) noexcept { a.swap(b); }
+
+    [[nodiscard]] constexpr size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] constexpr size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] constexpr size_t max_size() const noexcept {
+        return std::min<size_t>(kmax_capacity, Alloc_traits::max_size(allocator_));
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+
+    [[nodiscard]] constexpr bool full() const noexcept { return size_ == capacity_; }
+
+    constexpr T& front() noexcept { return start_in_memory_[head_]; }
+
+    constexpr const T& front() const noexcept { return start_in_memory_[head_]; }
+
+    constexpr T& back() noexcept { return *slot(size_ - 1); }
+
+    constexpr const T& back() const noexcept { return *slot(size_ - 1); }
+
+    constexpr T& operator[](size_t n) noexcept { return *slot(n); }
+
+    constexpr const T& operator[](size_t n) const noexcept { return *slot(n); }
+
+    constexpr T& at(size_t n) { return *slot(n); }
+
+    constexpr const T& at(size_t n) const { return *slot(n); }
+
+    template<typename... Args>
+    void emplace_back(Args&& ...args) {
+        if (size_ == capacity_) {
+            CB_THROW(FullBufferException());
+        }
+        Alloc_traits::construct(allocator_, slot(size_), std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    template<typename... Args>
+    void emplace_front(Args&& ...args) {
+        if (size_ == capacity_) {
+            CB_THROW(FullBufferException());
+        }
+        Index head = head_ > 0 ? Index(head_ - 1) : Index(capacity_ - 1);
+        Alloc_traits::construct(allocator_, start_in_memory_ + head, std::forward<Args>(args)...);
+        head_ = head;
+        ++size_;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void push_front(const T& value) { emplace_front(value); }
+
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    void pop_front() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        Alloc_traits::destroy(allocator_, start_in_memory_ + head_);
+        head_ = size_t(head_) + 1 == capacity_ ? Index(0) : Index(head_ + 1);
+        --size_;
+    }
+
+    void pop_back() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        Alloc_traits::destroy(allocator_, slot(size_ - 1));
+        --size_;
+    }
+
+    // Non-throwing variants: a full or empty buffer is reported by the return value.
+
+    bool try_push_back(const T& value) { return try_emplace_back(value); }
+
+    bool try_push_back(T&& value) { return try_emplace_back(std::move(value)); }
+
+    template<typename... Args>
+    bool try_emplace_back(Args&& ...args) {
+        if (size_ == capacity_) {
+            return false;
+        }
+        Alloc_traits::construct(allocator_, slot(size_), std::forward<Args>(args)...);
+        ++size_;
+        return true;
+    }
+
+    bool try_pop_front(T& value) {
+        if (size_ == 0) {
+            return false;
+        }
+        value = std::move(front());
+        pop_front();
+        return true;
+    }
+
+    std::optional<T> try_pop_front() {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+        std::optional<T> value(std::move(front()));
+        pop_front();
+        return value;
+    }
+
+    void clear() noexcept {
+        for (size_t k = 0; k < size_; ++k) {
+            Alloc_traits::destroy(allocator_, slot(k));
+        }
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    static Index checked(size_t capacity) {
+        if (capacity > kmax_capacity) {
+            CB_THROW(std::length_error("CCompactCircularBuffer capacity exceeds its index type"));
+        }
+        return static_cast<Index>(capacity);
+    }
+
+    // n < capacity_, so one conditional subtraction replaces the modulo.
+    constexpr T* slot(size_t n) const noexcept {
+        size_t index = size_t(head_) + n;
+        if (index >= capacity_) {
+            index -= capacity_;
+        }
+        return start_in_memory_ + index;
+    }
+
+    [[no_unique_address]] Alloc allocator_{};
+    T* start_in_memory_ = nullptr;
+    Index capacity_ = 0;
+    Index head_ = 0;
+    Index size_ = 0;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Circular buffer of integers compressed in blocks of block_samples values. A block keeps its
+// first value and the zigzag varint encoded deltas of the following ones. Whole blocks are
+// evicted from the head, so the buffer retains at least capacity most recent values.
+template<typename T = int64_t>
+class CCompressedCircularBuffer {
+    static_assert(std::is_integral_v<T>, "CCompressedCircularBuffer stores integral values");
+
+    struct Block {
+        size_t first_index = 0;
+        T first = 0;
+        T last = 0;
+        size_t count = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // Sequential decoder over the values, oldest first.
+    class const_iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = T;
+        using pointer = void;
+
+        constexpr const_iterator() noexcept = default;
+
+        constexpr T operator*() const noexcept { return value_; }
+
+        const_iterator& operator++() noexcept {
+            const Block& block = buffer_->blocks_[block_];
+            if (++position_ == block.count) {
+                ++block_;
+                position_ = 0;
+                offset_ = 0;
+                if (block_ < buffer_->blocks_.size()) {
+                    value_ = buffer_->blocks_[block_].first;
+                }
+            } else {
+                value_ = decode(block.bytes, offset_, value_);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        constexpr bool operator==(const const_iterator& other) const noexcept {
+            return block_ == other.block_ && position_ == other.position_;
+        }
+
+    private:
+        friend class CCompressedCircularBuffer;
+
+        const_iterator(const CCompressedCircularBuffer* buffer, size_t block) noexcept
+                : buffer_(buffer), block_(block) {
+            if (block_ < buffer_->blocks_.size()) {
+                value_ = buffer_->blocks_[block_].first;
+            }
+        }
+
+        const CCompressedCircularBuffer* buffer_ = nullptr;
+        size_t block_ = 0;
+        size_t position_ = 0;
+        size_t offset_ = 0;
+        T value_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    explicit CCompressedCircularBuffer(size_t capacity, size_t block_samples = 128)
+            : blocks_((capacity + checked(block_samples) - 1) / block_samples + 1), block_samples_(block_samples),
+              next_index_(0) {}
+
+    void push_back(T value) {
+        if (blocks_.empty() || blocks_.back().count == block_samples_) {
+            if (blocks_.size() == blocks_.capacity()) {
+                blocks_.pop_front();
+            }
+            Block block;
+            block.first_index = next_index_;
+            block.first = value;
+            block.bytes.reserve(block_samples_);
+            blocks_.push_back(std::move(block));
+        } else {
+            encode(blocks_.back().bytes, blocks_.back().last, value);
+        }
+        blocks_.back().last = value;
+        ++blocks_.back().count;
+        ++next_index_;
+    }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    const_iterator end() const noexcept { return const_iterator(this, blocks_.size()); }
+
+    // Iterator to the n-th value: O(1) block lookup, then decoding inside the block.
+    const_iterator seek(size_t n) const noexcept {
+        if (n >= size()) {
+            return end();
+        }
+        const_iterator it(this, n / block_samples_);
+        for (size_t k = n % block_samples_; k > 0; --k) {
+            ++it;
+        }
+        return it;
+    }
+
+    T operator[](size_t n) const noexcept { return *seek(n); }
+
+    T front() const noexcept { return blocks_.front().first; }
+
+    T back() const noexcept { return blocks_.back().last; }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return blocks_.empty() ? 0 : next_index_ - blocks_.front().first_index;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return blocks_.empty(); }
+
+    [[nodiscard]] size_t block_samples() const noexcept { return block_samples_; }
+
+    // Sequence number of the oldest retained value, counting every value ever pushed.
+    [[nodiscard]] size_t first_index() const noexcept {
+        return blocks_.empty() ? next_index_ : blocks_.front().first_index;
+    }
+
+    // Bytes used by encoded values and block headers.
+    [[nodiscard]] size_t memory_usage() const noexcept {
+        size_t n = blocks_.capacity() * sizeof(Block);
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            n += blocks_[i].bytes.capacity();
+        }
+        return n;
+    }
+
+    void clear() {
+        blocks_.clear();
+    }
+
+private:
+    static size_t checked(size_t block_samples) {
+        if (block_samples == 0) {
+            CB_THROW(std::invalid_argument("CCompressedCircularBuffer block size must be positive"));
+        }
+        return block_samples;
+    }
+
+    static void encode(std::vector<uint8_t>& bytes, T previous, T value) {
+        uint64_t delta = static_cast<uint64_t>(value) - static_cast<uint64_t>(previous);
+        uint64_t zigzag = (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+        while (zigzag >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(zigzag));
+    }
+
+    static T decode(const std::vector<uint8_t>& bytes, size_t& offset, T previous) noexcept {
+        uint64_t zigzag = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = bytes[offset++];
+            zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                break;
+            }
+        }
+        uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        return static_cast<T>(static_cast<uint64_t>(previous) + delta);
+    }
+
+    CCircularBuffer<Block> blocks_;
+    size_t block_samples_;
+    size_t next_index_;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "CCircularBuffer.h"
+#include "CLinearProbingTable.h"
+
+// Keys of the last window insertions with O(1) membership tests, e.g. message ids for idempotency.
+// The keys sit in a ring in arrival order and, with an occurrence count, in an open-addressing
+// (linear probing) table of at least twice the window size. Evicting the oldest key decrements
+// its count and removes it from the table at zero. No per-element heap nodes are allocated.
+// Key must be default constructible and copyable.
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class CDedupWindow {
+public:
+    using key_type = Key;
+    using size_type = std::size_t;
+
+    explicit CDedupWindow(size_t window, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+            : keys_(window), buckets_(window, Bucket{}), hash_(hash), equal_(equal) {}
+
+    [[nodiscard]] bool contains(const Key& key) const {
+        return buckets_[find_position(key)].count != 0;
+    }
+
+    // Occurrences of key in the window.
+    [[nodiscard]] size_t count(const Key& key) const {
+        return buckets_[find_position(key)].count;
+    }
+
+    // Adds key unless it is in the window already. Returns true if it was added.
+    bool insert_if_absent(const Key& key) {
+        size_t position = find_position(key);
+        if (buckets_[position].count != 0) {
+            return false;
+        }
+        if (keys_.capacity() == 0) {
+            CB_THROW(FullBufferException());
+        }
+        if (keys_.size() == keys_.capacity()) {
+            evict();
+            position = find_position(key);
+        }
+        buckets_[position].key = key;
+        buckets_[position].count = 1;
+        keys_.push_back(key);
+        return true;
+    }
+
+    // Adds key even if it is already in the window, evicting the oldest key when full.
+    void push(const Key& key) {
+        if (keys_.capacity() == 0) {
+            CB_THROW(FullBufferException());
+        }
+        if (keys_.size() == keys_.capacity()) {
+            evict();
+        }
+        size_t position = find_position(key);
+        if (buckets_[position].count == 0) {
+            buckets_[position].key = key;
+        }
+        ++buckets_[position].count;
+        keys_.push_back(key);
+    }
+
+    // Removes the oldest key.
+    void pop_front() {
+        if (keys_.empty()) {
+            CB_THROW(EmptyBufferException());
+        }
+        evict();
+    }
+
+    // Window contents in arrival order.
+    const CCircularBuffer<Key>& keys() const noexcept { return keys_; }
+
+    [[nodiscard]] size_t size() const noexcept { return keys_.size(); }
+
+    [[nodiscard]] size_t window() const noexcept { return keys_.capacity(); }
+
+    [[nodiscard]] bool empty() const noexcept { return keys_.empty(); }
+
+    void clear() {
+        keys_.clear();
+        buckets_.clear();
+    }
+
+private:
+    struct Bucket {
+        Key key{};
+        uint32_t count = 0; // 0 marks an empty bucket
+    };
+
+    struct EmptyBucket {
+        bool operator()(const Bucket& bucket) const noexcept { return bucket.count == 0; }
+    };
+
+    // Position of key in the table or the empty position where it would be inserted.
+    size_t find_position(const Key& key) const {
+        return buckets_.find(hash_(key), [&](const Bucket& bucket) { return equal_(bucket.key, key); });
+    }
+
+    void evict() {
+        size_t position = find_position(keys_.front());
+        if (--buckets_[position].count == 0) {
+            buckets_.erase(position, [this](const Bucket& bucket) { return hash_(bucket.key); });
+        }
+        keys_.pop_front();
+    }
+
+    CCircularBuffer<Key> keys_;
+    CLinearProbingTable<Bucket, EmptyBucket> buckets_;
+    Hash hash_;
+    KeyEqual equal_;
+};
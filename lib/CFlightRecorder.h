@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+// Trace event kept by CFlightRecorder. code and args are defined by the application.
+struct FlightEvent {
+    uint64_t timestamp; // steady_clock, ns
+    uint32_t code;
+    uint32_t thread;    // registration index of the recording thread
+    uint64_t args[2];
+};
+
+static_assert(sizeof(FlightEvent) == 32 && std::is_trivially_copyable_v<FlightEvent>);
+
+// Dump file layout: FlightDumpHeader, then for every thread a FlightDumpThread followed by
+// its count events, oldest first. All integers are in host byte order.
+struct FlightDumpHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t event_size;
+    uint32_t threads;
+    uint64_t dropped_threads; // threads beyond kmax_threads, their events were not kept
+};
+
+struct FlightDumpThread {
+    uint32_t thread;
+    int32_t os_thread;
+    uint64_t written; // events ever recorded by the thread
+    uint64_t count;   // events in the dump, at most the ring capacity
+};
+
+// Always-on recorder of the last events of every thread. Each thread appends to its own
+// overwrite ring (a power-of-two array addressed by write index), so record() is a timestamp,
+// one 32-byte store and a release store of the write index, with no locks or read-modify-writes.
+//
+// dump() only reads atomics and calls write(2), so it may run in a signal handler;
+// install_crash_handler() does that on SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT. Events that
+// other threads are writing at the moment of the dump may come out torn.
+// Rings stay allocated after their thread exits, until the recorder is destroyed.
+// Meant as one recorder per process: a thread caches only its last recorder, so alternating
+// between two recorders registers a new ring on every switch.
+class CFlightRecorder {
+public:
+    static constexpr size_t kmax_threads = 256;
+    static constexpr uint32_t kversion = 1;
+
+    // events_per_thread is rounded up to a power of two.
+    explicit CFlightRecorder(size_t events_per_thread = 4096) : id_(next_id().fetch_add(1) + 1) {
+        capacity_ = 1;
+        while (capacity_ < events_per_thread) {
+            capacity_ *= 2;
+        }
+        for (auto& ring: rings_) {
+            ring.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    CFlightRecorder(const CFlightRecorder&) = delete;
+
+    CFlightRecorder& operator=(const CFlightRecorder&) = delete;
+
+    // No thread may be recording while the recorder is destroyed.
+    ~CFlightRecorder() {
+        if (installed() == this) {
+            installed().store(nullptr);
+        }
+        for (auto& ring: rings_) {
+            delete ring.load(std::memory_order_acquire);
+        }
+    }
+
+    void record(uint32_t code, uint64_t arg0 = 0, uint64_t arg1 = 0) noexcept {
+        ThreadRing* ring = local_ring();
+        if (ring == nullptr) {
+            return;
+        }
+        auto timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        uint64_t index = ring->written.load(std::memory_order_relaxed);
+        ring->slots[index & (capacity_ - 1)] = FlightEvent{timestamp, code, ring->thread, {arg0, arg1}};
+        ring->written.store(index + 1, std::memory_order_release);
+    }
+
+    // Writes the dump to fd. Async-signal-safe. Returns false if a write failed.
+    bool dump(int fd) const noexcept {
+        size_t registered = std::min(registered_.load(std::memory_order_acquire), kmax_threads);
+        FlightDumpHeader header{{'C', 'B', 'F', 'R'}, kversion, sizeof(FlightEvent), 0, dropped_threads()};
+        for (size_t i = 0; i < registered; ++i) {
+            header.threads += rings_[i].load(std::memory_order_acquire) != nullptr;
+        }
+        if (!write_all(fd, &header, sizeof(header))) {
+            return false;
+        }
+
+        for (size_t i = 0; i < registered && header.threads > 0; ++i) {
+            const ThreadRing* ring = rings_[i].load(std::memory_order_acquire);
+            if (ring == nullptr) {
+                continue;
+            }
+            --header.threads; // a ring registered after counting is left out
+            uint64_t written = ring->written.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(written, capacity_);
+            FlightDumpThread thread{ring->thread, ring->os_thread, written, count};
+            size_t first = (written - count) & (capacity_ - 1);
+            size_t contiguous = std::min<size_t>(count, capacity_ - first);
+            if (!write_all(fd, &thread, sizeof(thread)) ||
+                !write_all(fd, ring->slots + first, contiguous * sizeof(FlightEvent)) ||
+                !write_all(fd, ring->slots, (count - contiguous) * sizeof(FlightEvent))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Dumps to path when the process receives a fatal signal, then lets the signal take its
+    // default action. The file is created in the handler with open(2); path is copied.
+    bool install_crash_handler(const char* path) noexcept {
+        if (std::strlen(path) >= sizeof(crash_path())) {
+            return false;
+        }
+        std::strcpy(crash_path(), path);
+        installed().store(this);
+
+        struct sigaction action{};
+        action.sa_handler = &CFlightRecorder::on_fatal_signal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESETHAND | SA_ONSTACK;
+        for (int signal: {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT}) {
+            if (sigaction(signal, &action, nullptr) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] size_t events_per_thread() const noexcept { return capacity_; }
+
+    [[nodiscard]] size_t threads() const noexcept {
+        return std::min(registered_.load(std::memory_order_acquire), kmax_threads);
+    }
+
+    [[nodiscard]] uint64_t dropped_threads() const noexcept {
+        size_t registered = registered_.load(std::memory_order_relaxed);
+        return registered > kmax_threads ? registered - kmax_threads : 0;
+    }
+
+private:
+    struct alignas(64) ThreadRing {
+        ThreadRing(FlightEvent* slots, uint32_t thread, int32_t os_thread)
+                : slots(slots), thread(thread), os_thread(os_thread) {}
+
+        ~ThreadRing() { delete[] slots; }
+
+        FlightEvent* slots;
+        uint32_t thread;
+        int32_t os_thread;
+        alignas(64) std::atomic<uint64_t> written{0};
+    };
+
+    struct LocalRing {
+        uint64_t owner = 0;
+        ThreadRing* ring = nullptr;
+    };
+
+    ThreadRing* local_ring() noexcept {
+        thread_local LocalRing local;
+        if (local.owner != id_) {
+            local.owner = id_;
+            local.ring = register_thread();
+        }
+        return local.ring;
+    }
+
+    ThreadRing* register_thread() noexcept {
+        size_t index = registered_.fetch_add(1);
+        if (index >= kmax_threads) {
+            return nullptr;
+        }
+#if defined(__linux__)
+        auto os_thread = static_cast<int32_t>(syscall(SYS_gettid));
+#else
+        int32_t os_thread = 0;
+#endif
+        // Out of memory the thread just records nothing: record() is noexcept.
+        auto* slots = new(std::nothrow) FlightEvent[capacity_]();
+        if (slots == nullptr) {
+            return nullptr;
+        }
+        auto* ring = new(std::nothrow) ThreadRing(slots, static_cast<uint32_t>(index), os_thread);
+        if (ring == nullptr) {
+            delete[] slots;
+            return nullptr;
+        }
+        rings_[index].store(ring, std::memory_order_release);
+        return ring;
+    }
+
+    static bool write_all(int fd, const void* data, size_t size) noexcept {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t n = ::write(fd, p, size);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static void on_fatal_signal(int signal) {
+        int saved_errno = errno;
+        if (const CFlightRecorder* recorder = installed().exchange(nullptr)) {
+            int fd = ::open(crash_path(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd >= 0) {
+                recorder->dump(fd);
+                ::close(fd);
+            }
+        }
+        errno = saved_errno;
+        // SA_RESETHAND restored the default action.
+        raise(signal);
+    }
+
+    static std::atomic<uint64_t>& next_id() noexcept {
+        static std::atomic<uint64_t> id{0};
+        return id;
+    }
+
+    static std::atomic<const CFlightRecorder*>& installed() noexcept {
+        static std::atomic<const CFlightRecorder*> recorder{nullptr};
+        return recorder;
+    }
+
+    static char (&crash_path() noexcept)[4096] {
+        static char path[4096];
+        return path;
+    }
+
+    uint64_t id_;
+    size_t capacity_;
+    std::atomic<size_t> registered_{0};
+    std::atomic<ThreadRing*> rings_[kmax_threads];
+};
+
+// Contents of a dump, events of all threads merged by timestamp.
+struct FlightRecording {
+    FlightDumpHeader header;
+    std::vector<FlightDumpThread> threads;
+    std::vector<FlightEvent> events;
+};
+
+// Parses the output of CFlightRecorder::dump(); std::nullopt if it is truncated or not a dump.
+inline std::optional<FlightRecording> parse_flight_dump(std::span<const std::byte> data) {
+    FlightRecording recording{};
+    auto take = [&data](void* out, size_t size) {
+        if (data.size() < size) {
+            return false;
+        }
+        std::memcpy(out, data.data(), size);
+        data = data.subspan(size);
+        return true;
+    };
+
+    if (!take(&recording.header, sizeof(FlightDumpHeader)) ||
+        std::memcmp(recording.header.magic, "CBFR", 4) != 0 ||
+        recording.header.version != CFlightRecorder::kversion ||
+        recording.header.event_size != sizeof(FlightEvent)) {
+        return std::nullopt;
+    }
+    for (uint32_t i = 0; i < recording.header.threads; ++i) {
+        FlightDumpThread thread{};
+        if (!take(&thread, sizeof(thread)) || thread.count > data.size() / sizeof(FlightEvent)) {
+            return std::nullopt;
+        }
+        size_t first = recording.events.size();
+        recording.events.resize(first + thread.count);
+        take(recording.events.data() + first, thread.count * sizeof(FlightEvent));
+        recording.threads.push_back(thread);
+    }
+    std::stable_sort(recording.events.begin(), recording.events.end(),
+                     [](const FlightEvent& a, const FlightEvent& b) { return a.timestamp < b.timestamp; });
+    return recording;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "CCircularBuffer.h"
+
+enum class HugePagePrefault {
+    none,     // pages are faulted in on first touch
+    populate, // MAP_POPULATE faults every page in mmap
+    touch     // writes one byte per page after mmap
+};
+
+// Allocator for very large buffers: allocations of at least kmin_size bytes are mmap-ed at a huge
+// page aligned address, rounded up to the huge page size and advised with MADV_HUGEPAGE. If transparent huge pages are
+// unavailable the memory is still valid and uses regular pages. Smaller allocations use operator new.
+// Example: CCircularBuffer<Tick, CHugePageAllocator<Tick, HugePagePrefault::populate>> ring(1 << 28);
+template<typename T, HugePagePrefault Prefault = HugePagePrefault::none, bool HugeTlb = false>
+class CHugePageAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = CHugePageAllocator<U, Prefault, HugeTlb>;
+    };
+
+    static constexpr size_t khuge_page_size = 2 * 1024 * 1024;
+    static constexpr size_t kmin_size = khuge_page_size;
+
+    constexpr CHugePageAllocator() noexcept = default;
+
+    template<typename U>
+    constexpr CHugePageAllocator(const CHugePageAllocator<U, Prefault, HugeTlb>&) noexcept {}
+
+    // Leaves room for rounding up and for the alignment slack of the mapping.
+    static constexpr size_t max_size() noexcept {
+        return (std::numeric_limits<size_t>::max() - 2 * khuge_page_size) / sizeof(T);
+    }
+
+    T* allocate(size_t n) {
+        if (n > max_size()) {
+            CB_THROW(std::bad_alloc());
+        }
+        size_t bytes = n * sizeof(T);
+        if (bytes < kmin_size) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+        }
+#if defined(__linux__)
+        size_t length = round_up(bytes);
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        if constexpr (Prefault == HugePagePrefault::populate) {
+            flags |= MAP_POPULATE;
+        }
+
+        void* p = MAP_FAILED;
+        if constexpr (HugeTlb) {
+            // Needs reserved pages in /proc/sys/vm/nr_hugepages, falls back to regular mmap otherwise.
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+        }
+        if (p == MAP_FAILED) {
+            p = map_aligned(length, flags);
+            if (p == MAP_FAILED) {
+                CB_THROW(std::bad_alloc());
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+        }
+        if constexpr (Prefault == HugePagePrefault::touch) {
+            auto* bytes_p = static_cast<volatile char*>(p);
+            for (size_t offset = 0; offset < length; offset += 4096) {
+                bytes_p[offset] = 0;
+            }
+        }
+        return static_cast<T*>(p);
+#else
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(alignof(T))));
+#endif
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+#if defined(__linux__)
+        if (bytes >= kmin_size) {
+            munmap(p, round_up(bytes));
+            return;
+        }
+#endif
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    // True if the kernel allows MADV_HUGEPAGE regions to use transparent huge pages.
+    static bool transparent_huge_pages_available() {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string mode;
+        std::getline(file, mode);
+        return mode.find("[always]") != std::string::npos || mode.find("[madvise]") != std::string::npos;
+    }
+
+    template<typename U, HugePagePrefault P, bool H>
+    constexpr bool operator==(const CHugePageAllocator<U, P, H>&) const noexcept {
+        return P == Prefault && H == HugeTlb;
+    }
+
+private:
+    static constexpr size_t round_up(size_t bytes) noexcept {
+        return (bytes + khuge_page_size - 1) / khuge_page_size * khuge_page_size;
+    }
+
+#if defined(__linux__)
+    // mmap only guarantees base page alignment, and THP can only back huge page aligned ranges:
+    // over-map by one huge page and unmap the slack on both sides.
+    static void* map_aligned(size_t length, int flags) noexcept {
+        size_t mapped = length + khuge_page_size;
+        void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED) {
+            return p;
+        }
+        auto start = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = round_up(start);
+        size_t head = aligned - start;
+        if (head != 0) {
+            munmap(p, head);
+        }
+        size_t tail = mapped - head - length;
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+#endif
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Open-addressing (linear probing) table used as the key index of CClockCache and CDedupWindow.
+// It holds at least twice as many buckets as elements, a power of two. The table knows nothing
+// about keys: callers pass the hash and a match predicate for lookups, and a hash_of function for
+// erasing. is_empty(bucket) tells free buckets apart; empty is the value of a free bucket.
+template<typename Bucket, typename IsEmpty>
+class CLinearProbingTable {
+public:
+    CLinearProbingTable(size_t elements, const Bucket& empty, IsEmpty is_empty = IsEmpty())
+            : buckets_(table_size(elements), empty), mask_(buckets_.size() - 1), empty_(empty),
+              is_empty_(std::move(is_empty)) {}
+
+    [[nodiscard]] size_t home(size_t hash) const noexcept {
+        // Fibonacci hashing spreads weak std::hash values (identity for integers) over the table.
+        return (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull >> 32) & mask_;
+    }
+
+    // Position of the bucket for which matches(bucket) holds, or the empty position where such
+    // a bucket would be inserted.
+    template<typename Matches>
+    size_t find(size_t hash, Matches&& matches) const {
+        size_t position = home(hash);
+        while (!is_empty_(buckets_[position]) && !matches(buckets_[position])) {
+            position = (position + 1) & mask_;
+        }
+        return position;
+    }
+
+    [[nodiscard]] bool occupied(size_t position) const { return !is_empty_(buckets_[position]); }
+
+    Bucket& operator[](size_t position) noexcept { return buckets_[position]; }
+
+    const Bucket& operator[](size_t position) const noexcept { return buckets_[position]; }
+
+    // Frees the bucket at position; hash_of(bucket) is the hash of an occupied bucket.
+    // Backward shift deletion keeps probe sequences intact without tombstones.
+    template<typename HashOf>
+    void erase(size_t position, HashOf&& hash_of) {
+        size_t next = (position + 1) & mask_;
+        while (!is_empty_(buckets_[next])) {
+            size_t h = home(hash_of(buckets_[next]));
+            if (((next - h) & mask_) >= ((next - position) & mask_)) {
+                buckets_[position] = std::move(buckets_[next]);
+                position = next;
+            }
+            next = (next + 1) & mask_;
+        }
+        buckets_[position] = empty_;
+    }
+
+    void clear() {
+        for (Bucket& bucket: buckets_) {
+            bucket = empty_;
+        }
+    }
+
+private:
+    static size_t table_size(size_t elements) {
+        size_t n = 1;
+        while (n < 2 * elements) {
+            n *= 2;
+        }
+        return n;
+    }
+
+    std::vector<Bucket> buckets_;
+    size_t mask_;
+    Bucket empty_;
+    [[no_unique_address]] IsEmpty is_empty_;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear bucketing of uint64_t values in the style of HdrHistogram: values below 2^SubBits
+// get a bucket each, larger ones keep SubBits significant bits, so the relative error of a bucket
+// bound is below 2^(1 - SubBits). Buckets are numbered 0..kcount-1 in value order.
+template<unsigned SubBits>
+struct CLogLinearBuckets {
+    static_assert(SubBits >= 2 && SubBits < 64);
+
+    static constexpr uint64_t kexact = uint64_t(1) << SubBits;
+    static constexpr uint64_t khalf = kexact / 2;
+    static constexpr size_t kcount = kexact + (64 - SubBits) * khalf;
+
+    static constexpr size_t bucket(uint64_t value) noexcept {
+        if (value < kexact) {
+            return value;
+        }
+        unsigned shift = std::bit_width(value) - SubBits;
+        return kexact + (shift - 1) * khalf + ((value >> shift) - khalf);
+    }
+
+    // Largest value in the bucket.
+    static constexpr uint64_t upper_bound(size_t index) noexcept {
+        if (index < kexact) {
+            return index;
+        }
+        size_t shift = (index - kexact) / khalf + 1;
+        uint64_t sub = (index - kexact) % khalf + khalf;
+        return ((sub + 1) << shift) - 1;
+    }
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Single-writer, multi-reader overwrite ring of trivially copyable values.
+// Every slot carries a sequence number: odd while the writer is copying into it, 2 * (index + 1)
+// once it holds the element with that index. Readers copy a slot optimistically and retry if the
+// sequence changed meanwhile; the writer never waits for readers.
+template<typename T>
+class CSeqlockCircularBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "CSeqlockCircularBuffer copies values as raw words");
+
+    static constexpr size_t kwords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> words[kwords];
+    };
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit CSeqlockCircularBuffer(size_t capacity)
+            : slots_(std::make_unique<Slot[]>(capacity)), capacity_(capacity) {}
+
+    // Writer only.
+    void push_back(const T& value) noexcept {
+        uint64_t index = write_index_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[index % capacity_];
+
+        uint64_t words[kwords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kwords; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(2 * (index + 1), std::memory_order_release);
+        write_index_.store(index + 1, std::memory_order_release);
+    }
+
+    // Copies the element with the given index (counting every push) into out.
+    // Returns false if it was not written yet or has already been overwritten.
+    bool read(uint64_t index, T& out) const noexcept {
+        const Slot& slot = slots_[index % capacity_];
+        uint64_t expected = 2 * (index + 1);
+        uint64_t words[kwords];
+        while (true) {
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before == expected - 1) {
+                continue; // the writer is copying this very element
+            }
+            if (before != expected) {
+                return false;
+            }
+            for (size_t i = 0; i < kwords; ++i) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&out, words, sizeof(T));
+                return true;
+            }
+        }
+    }
+
+    // Copies the newest value into out. Returns false if nothing was pushed yet.
+    bool read_latest(T& out) const noexcept {
+        return read_latest(1, &out) == 1;
+    }
+
+    // Copies up to k newest values to out[0..n), oldest first, and returns n.
+    // If the writer laps the reader during the copy the whole window is read again.
+    size_t read_latest(size_t k, T* out) const noexcept {
+        while (true) {
+            uint64_t written = write_index_.load(std::memory_order_acquire);
+            size_t n = std::min<uint64_t>({k, written, capacity_});
+            uint64_t first = written - n;
+            size_t i = 0;
+            while (i < n && read(first + i, out[i])) {
+                ++i;
+            }
+            if (i == n) {
+                return n;
+            }
+        }
+    }
+
+    // Number of values ever pushed.
+    [[nodiscard]] uint64_t write_index() const noexcept { return write_index_.load(std::memory_order_acquire); }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return std::min<uint64_t>(write_index(), capacity_);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+private:
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    alignas(64) std::atomic<uint64_t> write_index_{0};
+};
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "CCircularBuffer.h"
+
+// Bounded ring of trivially copyable messages in a shared memory segment, for passing data
+// between processes without syscalls. One consumer; one producer, or several with
+// MultiProducer = true. Every slot carries a sequence number (Vyukov's bounded queue): producers
+// claim a position by bumping tail, copy the message and publish the slot; the consumer frees
+// it for the next lap.
+//
+// The segment holds only offsets and atomics, never pointers, so each process may map it at a
+// different address. The header records a magic, a layout version and the message size and is
+// checked on open(). A consumer blocked in pop_wait() sleeps on a futex; producers pay a syscall
+// only when a consumer is actually asleep.
+//
+// Errors of the underlying system calls are thrown as std::system_error.
+template<typename T, bool MultiProducer = false>
+class CSharedMemoryRing {
+    static_assert(std::is_trivially_copyable_v<T>, "messages are copied between processes as raw bytes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "process-shared atomics must be lock-free");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr uint32_t kmagic = 0x43425348; // "CBSH"
+    static constexpr uint32_t kversion = 1;
+
+    // Creates a named POSIX shared memory segment; fails if it already exists.
+    static CSharedMemoryRing create(const char* name, size_t capacity) {
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            CB_THROW(std::system_error(errno, std::generic_category(), "shm_open"));
+        }
+        return CSharedMemoryRing(fd, capacity);
+    }
+
+#if defined(__linux__)
+    // Creates an unnamed segment, shared with children by fork() or by passing fd() over a socket.
+    static CSharedMemoryRing create_anonymous(size_t capacity) {
+        int fd = memfd_create("CSharedMemoryRing", MFD_CLOEXEC);
+        if (fd < 0) {
+            CB_THROW(std::system_error(errno, std::generic_category(), "memfd_create"));
+        }
+        return CSharedMemoryRing(fd, capacity);
+    }
+#endif
+
+    // Maps an existing segment created by create().
+    static CSharedMemoryRing open(const char* name) {
+        int fd = shm_open(name, O_RDWR, 0);
+        if (fd < 0) {
+            CB_THROW(std::system_error(errno, std::generic_category(), "shm_open"));
+        }
+        return attach(fd);
+    }
+
+    // Maps an existing segment from a file descriptor, taking ownership of fd.
+    static CSharedMemoryRing attach(int fd) {
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            CB_THROW(std::system_error(EINVAL, std::generic_category(), "segment too small"));
+        }
+        CSharedMemoryRing ring;
+        ring.fd_ = fd;
+        ring.map(static_cast<size_t>(st.st_size));
+        Header& header = ring.header();
+        if (std::atomic_ref<uint32_t>(header.magic).load(std::memory_order_acquire) != kmagic ||
+            header.version != kversion || header.message_size != sizeof(T) ||
+            header.mapping_size != static_cast<uint64_t>(st.st_size) || header.slot_size != kslot_size ||
+            header.slots_offset != kslots_offset || header.capacity == 0 ||
+            kslots_offset > header.mapping_size ||
+            header.capacity > (header.mapping_size - kslots_offset) / kslot_size) {
+            CB_THROW(std::system_error(EPROTO, std::generic_category(), "incompatible ring segment"));
+        }
+        return ring;
+    }
+
+    static void unlink(const char* name) noexcept {
+        shm_unlink(name);
+    }
+
+    CSharedMemoryRing(CSharedMemoryRing&& other) noexcept
+            : base_(std::exchange(other.base_, nullptr)), mapping_size_(std::exchange(other.mapping_size_, 0)),
+              fd_(std::exchange(other.fd_, -1)) {}
+
+    CSharedMemoryRing& operator=(CSharedMemoryRing&& other) noexcept {
+        if (this != &other) {
+            release();
+            base_ = std::exchange(other.base_, nullptr);
+            mapping_size_ = std::exchange(other.mapping_size_, 0);
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    CSharedMemoryRing(const CSharedMemoryRing&) = delete;
+
+    CSharedMemoryRing& operator=(const CSharedMemoryRing&) = delete;
+
+    ~CSharedMemoryRing() {
+        release();
+    }
+
+    // Returns false if the ring is full.
+    bool try_push(const T& value) noexcept {
+        Header& h = header();
+        uint64_t position = h.tail.load(std::memory_order_relaxed);
+        Slot* s;
+        while (true) {
+            s = &slot(position);
+            uint64_t sequence = s->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<int64_t>(sequence - position);
+            if (difference < 0) {
+                return false;
+            }
+            if (difference > 0) {
+                position = h.tail.load(std::memory_order_relaxed);
+                continue;
+            }
+            if constexpr (MultiProducer) {
+                if (h.tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                h.tail.store(position + 1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        s->value = value;
+        s->sequence.store(position + 1, std::memory_order_release);
+
+        // Pairs with the fence in pop_wait(): either the consumer sees the message or we see it waiting.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (h.consumer_waiting.load(std::memory_order_relaxed) != 0) {
+            h.wake_sequence.fetch_add(1, std::memory_order_relaxed);
+            futex_wake(h.wake_sequence);
+        }
+        return true;
+    }
+
+    // Consumer only. Returns false if the ring is empty.
+    bool try_pop(T& out) noexcept {
+        Header& h = header();
+        uint64_t position = h.head.load(std::memory_order_relaxed);
+        Slot& s = slot(position);
+        if (s.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        out = s.value;
+        s.sequence.store(position + h.capacity, std::memory_order_release);
+        h.head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Sleeps until a message arrives or the timeout expires.
+    bool pop_wait(T& out, std::chrono::nanoseconds timeout) noexcept {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        Header& h = header();
+        while (!try_pop(out)) {
+            auto left = deadline - std::chrono::steady_clock::now();
+            if (left <= std::chrono::nanoseconds::zero()) {
+                return false;
+            }
+            uint32_t observed = h.wake_sequence.load(std::memory_order_relaxed);
+            h.consumer_waiting.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (try_pop(out)) {
+                h.consumer_waiting.store(0, std::memory_order_relaxed);
+                return true;
+            }
+            futex_wait(h.wake_sequence, observed, left);
+            h.consumer_waiting.store(0, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Approximate while producers or the consumer are active.
+    [[nodiscard]] size_t size() const noexcept {
+        const Header& h = header();
+        uint64_t tail = h.tail.load(std::memory_order_acquire);
+        uint64_t head = h.head.load(std::memory_order_acquire);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return static_cast<size_t>(header().capacity); }
+
+    [[nodiscard]] int fd() const noexcept { return fd_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t message_size;
+        uint64_t capacity;
+        uint64_t slots_offset;
+        uint64_t slot_size;
+        uint64_t mapping_size;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint32_t> consumer_waiting;
+        std::atomic<uint32_t> wake_sequence;
+    };
+
+    static constexpr size_t kslot_size = (sizeof(Slot) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    static constexpr size_t kslots_offset = (sizeof(Header) + 63) / 64 * 64;
+
+    CSharedMemoryRing() = default;
+
+    // Sizes and initializes a freshly created segment, taking ownership of fd.
+    CSharedMemoryRing(int fd, size_t capacity) : fd_(fd) {
+        if (capacity == 0) {
+            release();
+            CB_THROW(std::system_error(EINVAL, std::generic_category(), "zero capacity"));
+        }
+        size_t size = kslots_offset + capacity * kslot_size;
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            int error = errno;
+            release();
+            CB_THROW(std::system_error(error, std::generic_category(), "ftruncate"));
+        }
+        map(size);
+
+        auto* h = new(base_) Header{};
+        h->message_size = sizeof(T);
+        h->capacity = capacity;
+        h->slots_offset = kslots_offset;
+        h->slot_size = kslot_size;
+        h->mapping_size = size;
+        for (size_t i = 0; i < capacity; ++i) {
+            new(base_ + kslots_offset + i * kslot_size) Slot{{i}, {}};
+        }
+        h->version = kversion;
+        // Written last: open() in another process must not accept a half-initialized header.
+        std::atomic_ref<uint32_t>(h->magic).store(kmagic, std::memory_order_release);
+    }
+
+    void map(size_t size) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            int error = errno;
+            release();
+            CB_THROW(std::system_error(error, std::generic_category(), "mmap"));
+        }
+        base_ = static_cast<std::byte*>(p);
+        mapping_size_ = size;
+    }
+
+    void release() noexcept {
+        if (base_ != nullptr) {
+            munmap(base_, mapping_size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    Header& header() const noexcept { return *std::launder(reinterpret_cast<Header*>(base_)); }
+
+    Slot& slot(uint64_t position) const noexcept {
+        const Header& h = header();
+        return *std::launder(reinterpret_cast<Slot*>(base_ + h.slots_offset + (position % h.capacity) * h.slot_size));
+    }
+
+    static void futex_wait(std::atomic<uint32_t>& word, uint32_t observed, std::chrono::nanoseconds timeout) noexcept {
+#if defined(__linux__)
+        auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        timespec ts{static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, observed, &ts, nullptr, 0);
+#else
+        (void) word;
+        (void) observed;
+        (void) timeout;
+        std::this_thread::yield();
+#endif
+    }
+
+    static void futex_wake(std::atomic<uint32_t>& word) noexcept {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+        (void) word;
+#endif
+    }
+
+    std::byte* base_ = nullptr;
+    size_t mapping_size_ = 0;
+    int fd_ = -1;
+};
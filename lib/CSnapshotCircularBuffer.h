@@ -0,0 +1,228 @@
+#pragma once
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+template<typename T>
+class CSnapshotCircularBuffer;
+
+// Immutable view of a CSnapshotCircularBuffer at the moment snapshot() was called.
+// It shares chunks with the live buffer and may be read from any thread.
+template<typename T>
+class CCircularBufferSnapshot {
+    using Chunk = std::vector<T>;
+    using Table = std::vector<std::shared_ptr<Chunk>>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = const T&;
+        using pointer = const T*;
+
+        constexpr const_iterator() noexcept = default;
+
+        const T& operator*() const noexcept { return (*snapshot_)[index_]; }
+
+        const T* operator->() const noexcept { return &(*snapshot_)[index_]; }
+
+        const T& operator[](difference_type n) const noexcept { return (*snapshot_)[index_ + n]; }
+
+        const_iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept { return const_iterator(snapshot_, index_++); }
+
+        const_iterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        const_iterator operator--(int) noexcept { return const_iterator(snapshot_, index_--); }
+
+        const_iterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        const_iterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        const_iterator operator+(difference_type n) const noexcept { return const_iterator(snapshot_, index_ + n); }
+
+        friend const_iterator operator+(difference_type n, const const_iterator& i) noexcept { return i + n; }
+
+        const_iterator operator-(difference_type n) const noexcept { return const_iterator(snapshot_, index_ - n); }
+
+        difference_type operator-(const const_iterator& other) const noexcept {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        bool operator==(const const_iterator& other) const noexcept { return index_ == other.index_; }
+
+        auto operator<=>(const const_iterator& other) const noexcept { return index_ <=> other.index_; }
+
+    private:
+        friend class CCircularBufferSnapshot;
+
+        const_iterator(const CCircularBufferSnapshot* snapshot, size_t index) noexcept
+                : snapshot_(snapshot), index_(index) {}
+
+        const CCircularBufferSnapshot* snapshot_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    CCircularBufferSnapshot() noexcept = default;
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+    const T& operator[](size_t n) const noexcept {
+        size_t index = (head_ + n) % capacity_;
+        return (*(*table_)[index / chunk_size_])[index % chunk_size_];
+    }
+
+    const T& front() const noexcept { return (*this)[0]; }
+
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+private:
+    friend class CSnapshotCircularBuffer<T>;
+
+    CCircularBufferSnapshot(std::shared_ptr<const Table> table, size_t chunk_size, size_t capacity,
+                            size_t head, size_t size) noexcept
+            : table_(std::move(table)), chunk_size_(chunk_size), capacity_(capacity), head_(head), size_(size) {}
+
+    std::shared_ptr<const Table> table_;
+    size_t chunk_size_ = 1;
+    size_t capacity_ = 1;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// Fixed-capacity overwrite ring with O(1) copy-on-write snapshots. Storage is split into
+// refcounted chunks of chunk_size elements; after a snapshot the writer copies a chunk only
+// when it is about to modify it.
+//
+// Single writer. snapshot() must be called by the writer thread or under the writer's lock,
+// the returned snapshot can then be read and destroyed on any thread.
+// T must be default constructible and copy assignable: chunks are allocated fully constructed.
+template<typename T>
+class CSnapshotCircularBuffer {
+    using Chunk = std::vector<T>;
+    using Table = std::vector<std::shared_ptr<Chunk>>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using snapshot_type = CCircularBufferSnapshot<T>;
+
+    explicit CSnapshotCircularBuffer(size_t capacity, size_t chunk_size = 256)
+            : table_(std::make_shared<Table>()), chunk_size_(checked(chunk_size)), capacity_(capacity) {
+        size_t chunks = (capacity_ + chunk_size_ - 1) / chunk_size_;
+        table_->reserve(chunks);
+        for (size_t i = 0; i < chunks; ++i) {
+            table_->push_back(std::make_shared<Chunk>(chunk_size_));
+        }
+    }
+
+    // Appends value, overwriting the oldest one if the buffer is full.
+    template<typename U>
+    void push_back(U&& value) {
+        if (capacity_ == 0) {
+            CB_THROW(FullBufferException());
+        }
+        writable((head_ + size_) % capacity_) = std::forward<U>(value);
+        if (size_ == capacity_) {
+            head_ = (head_ + 1) % capacity_;
+        } else {
+            ++size_;
+        }
+    }
+
+    void pop_front() {
+        if (size_ == 0) {
+            CB_THROW(EmptyBufferException());
+        }
+        head_ = (head_ + 1) % capacity_;
+        --size_;
+    }
+
+    const T& operator[](size_t n) const noexcept {
+        size_t index = (head_ + n) % capacity_;
+        return (*(*table_)[index / chunk_size_])[index % chunk_size_];
+    }
+
+    // Writable access; copies the chunk first if a snapshot still uses it.
+    T& at(size_t n) {
+        return writable((head_ + n) % capacity_);
+    }
+
+    const T& front() const noexcept { return (*this)[0]; }
+
+    const T& back() const noexcept { return (*this)[size_ - 1]; }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    // O(1): shares the chunk table with the live buffer.
+    [[nodiscard]] snapshot_type snapshot() const {
+        return snapshot_type(table_, chunk_size_, capacity_, head_, size_);
+    }
+
+private:
+    static size_t checked(size_t chunk_size) {
+        if (chunk_size == 0) {
+            CB_THROW(std::invalid_argument("CSnapshotCircularBuffer chunk size must be positive"));
+        }
+        return chunk_size;
+    }
+
+    // A use_count() of 1 is a relaxed load: each such observation is followed by an acquire
+    // fence that pairs with the release in the last snapshot's shared_ptr destructor, so that
+    // snapshot's reads happen before our writes to the table or the chunk.
+    T& writable(size_t index) {
+        if (table_.use_count() > 1) {
+            table_ = std::make_shared<Table>(*table_);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        std::shared_ptr<Chunk>& chunk = (*table_)[index / chunk_size_];
+        if (chunk.use_count() > 1) {
+            chunk = std::make_shared<Chunk>(*chunk);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return (*chunk)[index % chunk_size_];
+    }
+
+    std::shared_ptr<Table> table_;
+    size_t chunk_size_;
+    size_t capacity_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "CCircularBuffer.h"
+#include "CCircularBufferSerialization.h"
+
+// FIFO queue with bounded memory. The oldest elements wait in an in-memory head ring and the
+// newest in a tail ring; when the tail ring is full while older elements are still queued it is
+// appended to a segment file with one sequential write. When the head ring runs empty it is
+// refilled from the oldest segment with one large sequential read.
+//
+// memory_budget is split between the two rings and the I/O buffer. Segment files are created in
+// directory and unlinked right away, so they disappear with the process; a segment is closed once
+// it has been read back. I/O errors are thrown as std::system_error.
+template<typename T, typename Serializer = TrivialSerializer<T>>
+class CSpillingQueue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit CSpillingQueue(size_t memory_budget, std::string directory, size_t segment_bytes = 64 << 20)
+            : head_(ring_capacity(memory_budget)), tail_(ring_capacity(memory_budget)),
+              directory_(std::move(directory)), segment_bytes_(segment_bytes),
+              read_block_(std::max<size_t>(memory_budget / 3, sizeof(T))) {}
+
+    CSpillingQueue(const CSpillingQueue&) = delete;
+
+    CSpillingQueue& operator=(const CSpillingQueue&) = delete;
+
+    ~CSpillingQueue() {
+        for (Segment& segment: segments_) {
+            ::close(segment.fd);
+        }
+    }
+
+    void push_back(const T& value) {
+        if (tail_.empty() && segments_.empty() && head_.size() < head_.capacity()) {
+            head_.push_back(value);
+            return;
+        }
+        if (tail_.size() == tail_.capacity()) {
+            if (head_.empty() && segments_.empty()) {
+                // Nothing older is queued: the full tail becomes the head without touching disk.
+                head_.swap(tail_);
+            } else {
+                spill();
+            }
+        }
+        tail_.push_back(value);
+    }
+
+    // The queue must not be empty.
+    T& front() {
+        refill();
+        return head_.front();
+    }
+
+    void pop_front() {
+        refill();
+        head_.pop_front();
+    }
+
+    bool try_pop_front(T& value) {
+        if (empty()) {
+            return false;
+        }
+        refill();
+        value = std::move(head_.front());
+        head_.pop_front();
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return head_.size() + spilled_ + tail_.size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    // Elements currently on disk.
+    [[nodiscard]] size_t spilled() const noexcept { return spilled_; }
+
+    // Elements held by the two rings.
+    [[nodiscard]] size_t in_memory() const noexcept { return head_.size() + tail_.size(); }
+
+    [[nodiscard]] size_t segments() const noexcept { return segments_.size(); }
+
+private:
+    struct Segment {
+        int fd;
+        uint64_t write_offset;
+        uint64_t read_offset;
+        size_t count;
+    };
+
+    static size_t ring_capacity(size_t memory_budget) noexcept {
+        return std::max<size_t>(memory_budget / 3 / sizeof(T), 1);
+    }
+
+    // Moves the tail ring to the end of the newest segment.
+    void spill() {
+        io_buffer_.clear();
+        for (auto part: tail_.segments()) {
+            for (const T& value: part) {
+                Serializer::serialize(value, io_buffer_);
+            }
+        }
+        if (segments_.empty() || segments_.back().write_offset >= segment_bytes_) {
+            segments_.push_back(Segment{create_file(), 0, 0, 0});
+        }
+        Segment& segment = segments_.back();
+        write_all(segment.fd, io_buffer_.data(), io_buffer_.size(), segment.write_offset);
+        segment.write_offset += io_buffer_.size();
+        segment.count += tail_.size();
+        spilled_ += tail_.size();
+        tail_.clear();
+    }
+
+    // Makes sure the head ring is not empty, assuming the queue is not.
+    void refill() {
+        if (!head_.empty()) {
+            return;
+        }
+        if (segments_.empty()) {
+            if (tail_.empty()) {
+                CB_THROW(EmptyBufferException());
+            }
+            head_.swap(tail_);
+            return;
+        }
+
+        Segment& segment = segments_.front();
+        size_t block = read_block_;
+        while (head_.empty()) {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(block, segment.write_offset - segment.read_offset));
+            io_buffer_.resize(length);
+            read_all(segment.fd, io_buffer_.data(), length, segment.read_offset);
+
+            std::span<const std::byte> data(io_buffer_);
+            T value;
+            while (head_.size() < head_.capacity() && segment.count > 0) {
+                size_t used = Serializer::deserialize(data, value);
+                if (used == 0) {
+                    break;
+                }
+                head_.push_back(std::move(value));
+                data = data.subspan(used);
+                segment.read_offset += used;
+                --segment.count;
+                --spilled_;
+            }
+            if (head_.empty() && length == segment.write_offset - segment.read_offset) {
+                CB_THROW(std::system_error(EIO, std::generic_category(), "truncated spill segment"));
+            }
+            block *= 2; // a value larger than the block: read more
+        }
+
+        if (segment.count == 0) {
+            ::close(segment.fd);
+            segments_.pop_front();
+        }
+    }
+
+    int create_file() {
+        std::string path = directory_ + "/CSpillingQueue.XXXXXX";
+        int fd = mkstemp(path.data());
+        if (fd < 0) {
+            CB_THROW(std::system_error(errno, std::generic_category(), "mkstemp " + path));
+        }
+        ::unlink(path.c_str());
+        return fd;
+    }
+
+    static void write_all(int fd, const std::byte* data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                CB_THROW(std::system_error(errno, std::generic_category(), "pwrite"));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    }
+
+    static void read_all(int fd, std::byte* data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            ssize_t n = ::pread(fd, data, size, static_cast<off_t>(offset));
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                CB_THROW(std::system_error(n < 0 ? errno : EIO, std::generic_category(), "pread"));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    }
+
+    CCircularBuffer<T> head_;
+    CCircularBuffer<T> tail_;
+    std::deque<Segment> segments_;
+    size_t spilled_ = 0;
+    std::string directory_;
+    size_t segment_bytes_;
+    size_t read_block_;
+    std::vector<std::byte> io_buffer_;
+};
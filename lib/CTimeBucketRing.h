@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "CCircularBuffer.h"
+
+// Event counts over a sliding window of buckets * resolution, e.g. 600 buckets of 100ms for
+// the last minute. Every slot of the ring is one time bucket, oldest first and the current bucket
+// last; moving the clock forward pops expired buckets from the front and pushes zeroed ones,
+// at most buckets() of them however long the gap. A running total makes window sums O(1).
+// Events older than the window are dropped. Not thread-safe, see CAtomicTimeBucketRing.
+template<typename Count = uint64_t, typename Clock = std::chrono::steady_clock>
+class CTimeBucketRing {
+public:
+    using count_type = Count;
+    using duration = typename Clock::duration;
+    using time_point = typename Clock::time_point;
+
+    CTimeBucketRing(size_t buckets, duration resolution, time_point now = Clock::now())
+            : buckets_(buckets, Count{}), resolution_(resolution), current_(bucket_index(now)) {}
+
+    void add(Count n = 1) { add(Clock::now(), n); }
+
+    // Returns false if t is older than the window.
+    bool add(time_point t, Count n = 1) {
+        uint64_t index = bucket_index(t);
+        advance_to(index);
+        uint64_t age = current_ - index;
+        if (age >= buckets_.size()) {
+            return false;
+        }
+        buckets_[buckets_.size() - 1 - age] += n;
+        total_ += n;
+        return true;
+    }
+
+    // Sum over the window ending at now.
+    Count total(time_point now) {
+        advance(now);
+        return total_;
+    }
+
+    Count total() { return total(Clock::now()); }
+
+    void advance(time_point now) { advance_to(bucket_index(now)); }
+
+    // Bucket counts, oldest first.
+    const CCircularBuffer<Count>& buckets() const noexcept { return buckets_; }
+
+    [[nodiscard]] size_t size() const noexcept { return buckets_.size(); }
+
+    [[nodiscard]] duration resolution() const noexcept { return resolution_; }
+
+    [[nodiscard]] duration window() const noexcept {
+        return resolution_ * static_cast<typename duration::rep>(buckets_.size());
+    }
+
+    void clear() {
+        std::fill(buckets_.begin(), buckets_.end(), Count{});
+        total_ = Count{};
+    }
+
+private:
+    uint64_t bucket_index(time_point t) const noexcept {
+        return static_cast<uint64_t>(t.time_since_epoch() / resolution_);
+    }
+
+    void advance_to(uint64_t index) {
+        if (index <= current_) {
+            return;
+        }
+        uint64_t skipped = std::min<uint64_t>(index - current_, buckets_.size());
+        for (uint64_t i = 0; i < skipped; ++i) {
+            total_ -= buckets_.front();
+            buckets_.pop_front();
+            buckets_.push_back(Count{});
+        }
+        current_ = index;
+    }
+
+    CCircularBuffer<Count> buckets_;
+    duration resolution_;
+    uint64_t current_;
+    Count total_{};
+};
+
+// CTimeBucketRing for concurrent recording. Each bucket is one 64-bit atomic holding the low 32
+// bits of its bucket number and a 32-bit count, so add() is a compare-exchange that either
+// increments the current bucket or recycles an expired one; there is no shared clock to advance.
+// total() scans the buckets, O(buckets). Bucket numbers are compared modulo 2^32, so a bucket left
+// untouched for 2^32 resolutions (about 13 years at 100ms) may be taken for a current one.
+// A bucket must not receive 2^32 or more events.
+template<typename Clock = std::chrono::steady_clock>
+class CAtomicTimeBucketRing {
+public:
+    using duration = typename Clock::duration;
+    using time_point = typename Clock::time_point;
+
+    CAtomicTimeBucketRing(size_t buckets, duration resolution)
+            : slots_(std::max<size_t>(buckets, 1)), resolution_(resolution) {}
+
+    void add(uint32_t n = 1) noexcept { add(Clock::now(), n); }
+
+    // Returns false if t's slot already holds a newer bucket. Without a shared clock a t older than
+    // the window is still accepted when its slot is empty or even older; total() never counts it.
+    bool add(time_point t, uint32_t n = 1) noexcept {
+        auto tag = static_cast<uint32_t>(bucket_index(t));
+        std::atomic<uint64_t>& slot = slots_[bucket_index(t) % slots_.size()];
+        uint64_t word = slot.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t next;
+            if (tag_of(word) == tag) {
+                next = word + n;
+            } else if (static_cast<int32_t>(tag - tag_of(word)) > 0 || (word & 0xFFFFFFFFu) == 0) {
+                next = (uint64_t(tag) << 32) | n;
+            } else {
+                return false;
+            }
+            if (slot.compare_exchange_weak(word, next, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+
+    // Sum over the window ending at now.
+    [[nodiscard]] uint64_t total(time_point now) const noexcept {
+        auto tag = static_cast<uint32_t>(bucket_index(now));
+        uint64_t sum = 0;
+        for (const auto& slot: slots_) {
+            uint64_t word = slot.load(std::memory_order_relaxed);
+            if (static_cast<uint32_t>(tag - tag_of(word)) < slots_.size()) {
+                sum += word & 0xFFFFFFFFu;
+            }
+        }
+        return sum;
+    }
+
+    [[nodiscard]] uint64_t total() const noexcept { return total(Clock::now()); }
+
+    [[nodiscard]] size_t size() const noexcept { return slots_.size(); }
+
+    [[nodiscard]] duration resolution() const noexcept { return resolution_; }
+
+    [[nodiscard]] duration window() const noexcept {
+        return resolution_ * static_cast<typename duration::rep>(slots_.size());
+    }
+
+private:
+    static uint32_t tag_of(uint64_t word) noexcept { return static_cast<uint32_t>(word >> 32); }
+
+    uint64_t bucket_index(time_point t) const noexcept {
+        return static_cast<uint64_t>(t.time_since_epoch() / resolution_);
+    }
+
+    std::vector<std::atomic<uint64_t>> slots_;
+    duration resolution_;
+};
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "CCircularBuffer.h"
+#include "CLogLinearBuckets.h"
+
+// Exact quantiles over the last window values. The values are kept in a CCircularBuffer and,
+// ordered, in a treap whose nodes carry subtree sizes, so push() is O(log N) expected (insert the
+// new value, erase the evicted one) and quantile() is a single O(log N) descent.
+// T must be default constructible and copyable.
+template<typename T, typename Compare = std::less<T>>
+class CWindowedQuantile {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit CWindowedQuantile(size_t window, const Compare& compare = Compare())
+            : values_(window), compare_(compare) {
+        nodes_.reserve(window + 1);
+        nodes_.push_back(Node{}); // 0 is the empty tree
+    }
+
+    // Appends value, evicting the oldest one once the window is full.
+    void push(const T& value) {
+        if (values_.capacity() == 0) {
+            CB_THROW(FullBufferException());
+        }
+        if (values_.size() == values_.capacity()) {
+            erase(values_.front());
+            values_.pop_front();
+        }
+        values_.push_back(value);
+        insert(value);
+    }
+
+    void pop_front() {
+        if (values_.empty()) {
+            CB_THROW(EmptyBufferException());
+        }
+        erase(values_.front());
+        values_.pop_front();
+    }
+
+    // k-th smallest value in the window, 0-based. k must be less than size().
+    const T& select(size_t k) const noexcept {
+        uint32_t t = root_;
+        while (true) {
+            uint32_t left_size = nodes_[nodes_[t].left].size;
+            if (k < left_size) {
+                t = nodes_[t].left;
+            } else if (k == left_size) {
+                return nodes_[t].value;
+            } else {
+                k -= left_size + 1;
+                t = nodes_[t].right;
+            }
+        }
+    }
+
+    // Value of rank floor(q * (size() - 1)) for q in [0, 1]. The window must not be empty.
+    const T& quantile(double q) const noexcept {
+        return select(static_cast<size_t>(q * static_cast<double>(values_.size() - 1)));
+    }
+
+    const T& median() const noexcept { return quantile(0.5); }
+
+    // Window contents in arrival order.
+    const CCircularBuffer<T>& values() const noexcept { return values_; }
+
+    [[nodiscard]] size_t size() const noexcept { return values_.size(); }
+
+    [[nodiscard]] size_t window() const noexcept { return values_.capacity(); }
+
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+
+    void clear() {
+        values_.clear();
+        nodes_.resize(1);
+        free_.clear();
+        root_ = 0;
+    }
+
+private:
+    struct Node {
+        T value{};
+        uint32_t left = 0;
+        uint32_t right = 0;
+        uint32_t size = 0;
+        uint32_t priority = 0;
+    };
+
+    void update(uint32_t t) noexcept {
+        nodes_[t].size = nodes_[nodes_[t].left].size + nodes_[nodes_[t].right].size + 1;
+    }
+
+    uint32_t merge(uint32_t a, uint32_t b) noexcept {
+        if (a == 0 || b == 0) {
+            return a | b;
+        }
+        if (nodes_[a].priority > nodes_[b].priority) {
+            nodes_[a].right = merge(nodes_[a].right, b);
+            update(a);
+            return a;
+        }
+        nodes_[b].left = merge(a, nodes_[b].left);
+        update(b);
+        return b;
+    }
+
+    // Splits t into values less than value and the rest.
+    void split_less(uint32_t t, const T& value, uint32_t& less, uint32_t& rest) noexcept {
+        if (t == 0) {
+            less = rest = 0;
+            return;
+        }
+        if (compare_(nodes_[t].value, value)) {
+            split_less(nodes_[t].right, value, nodes_[t].right, rest);
+            less = t;
+        } else {
+            split_less(nodes_[t].left, value, less, nodes_[t].left);
+            rest = t;
+        }
+        update(t);
+    }
+
+    // Splits off the smallest value of a non-empty t.
+    uint32_t split_first(uint32_t t, uint32_t& rest) noexcept {
+        if (nodes_[t].left == 0) {
+            rest = nodes_[t].right;
+            nodes_[t].right = 0;
+            update(t);
+            return t;
+        }
+        uint32_t first = split_first(nodes_[t].left, nodes_[t].left);
+        update(t);
+        rest = t;
+        return first;
+    }
+
+    void insert(const T& value) {
+        uint32_t t;
+        if (free_.empty()) {
+            t = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(Node{});
+        } else {
+            t = free_.back();
+            free_.pop_back();
+        }
+        // xorshift32
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        nodes_[t] = Node{value, 0, 0, 1, seed_};
+
+        uint32_t less, rest;
+        split_less(root_, value, less, rest);
+        root_ = merge(merge(less, t), rest);
+    }
+
+    // Removes one occurrence of value, which must be present.
+    void erase(const T& value) {
+        uint32_t less, rest;
+        split_less(root_, value, less, rest);
+        uint32_t first = split_first(rest, rest);
+        free_.push_back(first);
+        root_ = merge(less, rest);
+    }
+
+    CCircularBuffer<T> values_;
+    Compare compare_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    uint32_t root_ = 0;
+    uint32_t seed_ = 2463534242u;
+};
+
+// Approximate quantiles of unsigned integers (e.g. latencies in ns) over the last window values,
+// for windows too large for the exact tree. Values are counted in log buckets in the style of
+// HdrHistogram: values below 2^SubBits are exact, larger ones keep SubBits significant bits, so the
+// relative error is below 2^(1 - SubBits). Bucket counts live in a Fenwick tree: push() and
+// quantile() are O(log B) in the number of buckets, independent of the window.
+template<unsigned SubBits = 7>
+class CWindowedQuantileSketch {
+public:
+    using value_type = uint64_t;
+    using size_type = std::size_t;
+
+    explicit CWindowedQuantileSketch(size_t window) : values_(window), tree_(kbuckets + 1, 0) {}
+
+    void push(uint64_t value) {
+        if (values_.capacity() == 0) {
+            CB_THROW(FullBufferException());
+        }
+        if (values_.size() == values_.capacity()) {
+            add(Buckets::bucket(values_.front()), -1);
+            values_.pop_front();
+        }
+        values_.push_back(value);
+        add(Buckets::bucket(value), 1);
+    }
+
+    // Upper bound of the bucket holding the value of rank floor(q * (size() - 1)); 0 if empty.
+    [[nodiscard]] uint64_t quantile(double q) const noexcept {
+        if (values_.empty()) {
+            return 0;
+        }
+        auto rank = static_cast<int64_t>(q * static_cast<double>(values_.size() - 1)) + 1;
+        // Fenwick descent for the first bucket whose prefix count reaches rank.
+        size_t position = 0;
+        for (size_t step = std::bit_floor(kbuckets); step > 0; step /= 2) {
+            if (position + step <= kbuckets && tree_[position + step] < rank) {
+                position += step;
+                rank -= tree_[position];
+            }
+        }
+        return Buckets::upper_bound(position);
+    }
+
+    [[nodiscard]] uint64_t median() const noexcept { return quantile(0.5); }
+
+    const CCircularBuffer<uint64_t>& values() const noexcept { return values_; }
+
+    [[nodiscard]] size_t size() const noexcept { return values_.size(); }
+
+    [[nodiscard]] size_t window() const noexcept { return values_.capacity(); }
+
+    [[nodiscard]] bool empty() const noexcept { return values_.empty(); }
+
+private:
+    using Buckets = CLogLinearBuckets<SubBits>;
+
+    static constexpr size_t kbuckets = Buckets::kcount;
+
+    void add(size_t index, int64_t delta) noexcept {
+        for (size_t i = index + 1; i <= kbuckets; i += i & (~i + 1)) {
+            tree_[i] += delta;
+        }
+    }
+
+    CCircularBuffer<uint64_t> values_;
+    std::vector<int64_t> tree_;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013). The owner thread pushes and pops at the bottom
+// without read-modify-write operations, except for a CAS when taking the last element; other
+// threads steal from the top with a CAS.
+//
+// The elements live in a power-of-two circular array that doubles when full. Thieves may
+// still read a replaced array, so replaced arrays are kept until the deque is destroyed;
+// their total size stays below the size of the current array.
+template<typename T>
+class CWorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "CWorkStealingDeque stores T in std::atomic<T>, use pointers or indices");
+
+    struct Array {
+        explicit Array(int64_t capacity) : capacity(capacity), mask(capacity - 1),
+                                           elements(std::make_unique<std::atomic<T>[]>(capacity)) {}
+
+        T get(int64_t i) const noexcept { return elements[i & mask].load(std::memory_order_relaxed); }
+
+        void put(int64_t i, T value) noexcept { elements[i & mask].store(value, std::memory_order_relaxed); }
+
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> elements;
+    };
+
+public:
+    using value_type = T;
+
+    // capacity is rounded up to a power of two.
+    explicit CWorkStealingDeque(int64_t capacity = 64) {
+        int64_t n = 1;
+        while (n < capacity) {
+            n *= 2;
+        }
+        arrays_.push_back(std::make_unique<Array>(n));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    CWorkStealingDeque(const CWorkStealingDeque&) = delete;
+
+    CWorkStealingDeque& operator=(const CWorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T value) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only. Takes the most recently pushed element.
+    std::optional<T> pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T value = a->get(b);
+        if (t == b) {
+            // Last element: race against thieves for it.
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    // Any thread. Takes the oldest element; empty if the deque is empty or another thread won the race.
+    std::optional<T> steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        Array* a = array_.load(std::memory_order_acquire);
+        T value = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // Approximate when other threads are active.
+    [[nodiscard]] size_t size() const noexcept {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return static_cast<size_t>(array_.load(std::memory_order_relaxed)->capacity);
+    }
+
+private:
+    Array* grow(Array* a, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<Array>(a->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, a->get(i));
+        }
+        Array* result = bigger.get();
+        arrays_.push_back(std::move(bigger));
+        array_.store(result, std::memory_order_release);
+        return result;
+    }
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays_; // owner only
+};
@@ -0,0 +1,65 @@
+#include "lib/CBipBuffer.h"
+#include <gtest/gtest.h>
+#include <deque>
+#include <numeric>
+#include <random>
+
+TEST(BipBuffer, ContiguousReservationTest) {
+    CBipBuffer<int> a(10);
+    std::span<int> w = a.reserve(8);
+    ASSERT_EQ(8, w.size());
+    std::iota(w.begin(), w.end(), 0);
+    a.commit(8);
+    a.consume(6);
+
+    // 2 free elements after A are not enough, the reservation moves to the start
+    w = a.reserve(4);
+    ASSERT_EQ(4, w.size());
+    EXPECT_EQ(a.read_block().data() - 6, w.data());
+    std::iota(w.begin(), w.end(), 8);
+    a.commit(3);
+    EXPECT_EQ(5, a.size());
+
+    EXPECT_EQ(0, a.reserve(4).size());
+    EXPECT_EQ(3, a.reserve(3).size());
+
+    std::span<const int> r = a.read_block();
+    ASSERT_EQ(2, r.size());
+    EXPECT_EQ(6, r[0]);
+    a.consume(2);
+    r = a.read_block();
+    ASSERT_EQ(3, r.size());
+    EXPECT_EQ(8, r[0]);
+    EXPECT_EQ(10, r[2]);
+}
+
+TEST(BipBuffer, StreamTest) {
+    CBipBuffer<> a(256);
+    std::deque<std::byte> model;
+    std::mt19937 random(11);
+    unsigned char next = 0;
+    for (int i = 0; i < 20'000; ++i) {
+        if (random() % 2 == 0) {
+            size_t n = random() % 64 + 1;
+            std::span<std::byte> w = a.reserve(n);
+            if (w.empty()) {
+                continue;
+            }
+            size_t used = random() % (n + 1);
+            for (size_t k = 0; k < used; ++k) {
+                w[k] = std::byte(next);
+                model.push_back(std::byte(next++));
+            }
+            a.commit(used);
+        } else {
+            std::span<std::byte> r = a.read_block();
+            size_t n = r.empty() ? 0 : random() % r.size() + 1;
+            for (size_t k = 0; k < n; ++k) {
+                ASSERT_EQ(model.front(), r[k]);
+                model.pop_front();
+            }
+            a.consume(n);
+        }
+        ASSERT_EQ(model.size(), a.size());
+    }
+}
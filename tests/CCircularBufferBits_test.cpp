@@ -0,0 +1,84 @@
+#include "lib/CCircularBufferBits.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include <random>
+
+TEST(BitsCircularBuffer, PushEvictCountTest) {
+    const size_t kcapacity = 200;
+    CCircularBufferBits<1> a(kcapacity);
+    std::deque<bool> model;
+    std::mt19937 random(7);
+    for (int i = 0; i < 5000; ++i) {
+        bool value = random() % 3 == 0;
+        a.push_back(value);
+        model.push_back(value);
+        if (model.size() > kcapacity) {
+            model.pop_front();
+        }
+        ASSERT_EQ(std::count(model.begin(), model.end(), true), a.count());
+    }
+    EXPECT_EQ(kcapacity, a.size());
+    EXPECT_TRUE(std::equal(model.begin(), model.end(), a.begin(), a.end()));
+}
+
+TEST(BitsCircularBuffer, ProxyReferenceTest) {
+    CCircularBufferBits<1> a(3);
+    a.push_back(false);
+    a.push_back(false);
+    a[1] = true;
+    EXPECT_EQ(true, a[1]);
+    EXPECT_EQ(false, a[0]);
+    EXPECT_EQ(1, a.count());
+    a[0] = a[1];
+    EXPECT_EQ(2, a.count());
+    a.pop_front();
+    EXPECT_EQ(1, a.count());
+}
+
+TEST(BitsCircularBuffer, SmallIntegersTest) {
+    CCircularBufferBits<4> a(5);
+    for (uint8_t i = 0; i < 20; ++i) {
+        a.push_back(i);
+    }
+    std::vector<uint8_t> b(a.begin(), a.end());
+    EXPECT_EQ((std::vector<uint8_t>{15, 0, 1, 2, 3}), b);
+    a[2] = 9;
+    EXPECT_EQ(9, a[2]);
+    EXPECT_EQ(0, a[1]);
+    EXPECT_EQ(3, a.back());
+}
+
+template<unsigned Bits>
+void check_against_model(size_t capacity) {
+    CCircularBufferBits<Bits> a(capacity);
+    std::deque<uint64_t> model;
+    std::mt19937_64 random(Bits);
+    const uint64_t mask = Bits == 64 ? ~uint64_t(0) : (uint64_t(1) << Bits) - 1;
+    for (int i = 0; i < 3000; ++i) {
+        uint64_t value = random() & mask;
+        a.push_back(static_cast<typename CCircularBufferBits<Bits>::value_type>(value));
+        model.push_back(value);
+        if (model.size() > capacity) {
+            model.pop_front();
+        }
+        if (i % 7 == 0) {
+            size_t k = random() % model.size();
+            model[k] = random() & mask;
+            a[k] = static_cast<typename CCircularBufferBits<Bits>::value_type>(model[k]);
+        }
+    }
+    ASSERT_EQ(model.size(), a.size());
+    for (size_t k = 0; k < model.size(); ++k) {
+        ASSERT_EQ(model[k], a[k]) << "Bits=" << Bits << " k=" << k;
+    }
+}
+
+TEST(BitsCircularBuffer, WordStraddlingWidthsTest) {
+    check_against_model<3>(100);
+    check_against_model<5>(77);
+    check_against_model<12>(50);
+    check_against_model<33>(31);
+    check_against_model<63>(10);
+    check_against_model<64>(9);
+}
@@ -0,0 +1,100 @@
+#include "lib/CCircularBufferMerge.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+    struct Sample {
+        uint64_t timestamp;
+        int source;
+
+        bool operator==(const Sample&) const = default;
+    };
+
+    struct ByTimestamp {
+        bool operator()(const Sample& a, const Sample& b) const { return a.timestamp < b.timestamp; }
+    };
+
+    // Sorted samples in a ring whose storage wraps.
+    CCircularBuffer<Sample> make_source(int source, size_t n, std::mt19937& rng) {
+        CCircularBuffer<Sample> buffer(n + 3);
+        for (int i = 0; i < 5; ++i) {
+            buffer.push_back({0, -1});
+            buffer.pop_front();
+        }
+        uint64_t t = 0;
+        for (size_t i = 0; i < n; ++i) {
+            t += rng() % 4;
+            buffer.push_back({t, source});
+        }
+        return buffer;
+    }
+}
+
+TEST(CircularBufferMerge, MatchesStableSortTest) {
+    std::mt19937 rng(9);
+    std::vector<CCircularBuffer<Sample>> buffers;
+    std::vector<Sample> expected;
+    for (int s = 0; s < 7; ++s) {
+        buffers.push_back(make_source(s, s == 3 ? 0 : 50 + 10 * s, rng));
+        expected.insert(expected.end(), buffers.back().begin(), buffers.back().end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), ByTimestamp());
+
+    std::vector<CCircularBuffer<Sample>*> sources;
+    for (auto& buffer: buffers) {
+        sources.push_back(&buffer);
+    }
+    CCircularBufferMerge<CCircularBuffer<Sample>, ByTimestamp> merge(sources);
+    EXPECT_EQ(expected.size(), merge.size());
+    EXPECT_EQ(expected[0], merge.top());
+    EXPECT_EQ(static_cast<size_t>(expected[0].source), merge.source());
+
+    std::vector<Sample> merged;
+    EXPECT_EQ(100, merge.drain_merged(std::back_inserter(merged), 100));
+    merge.pop();
+    merged.push_back(expected[100]);
+    merge.drain_merged(std::back_inserter(merged));
+    EXPECT_EQ(expected, merged);
+    EXPECT_TRUE(merge.empty());
+    EXPECT_THROW(merge.pop(), EmptyBufferException);
+    EXPECT_EQ(50, buffers[0].size());
+}
+
+TEST(CircularBufferMerge, ConsumeTest) {
+    CCircularBuffer<std::unique_ptr<int>> a(3);
+    CCircularBuffer<std::unique_ptr<int>> b(3);
+    for (int v: {1, 4, 6}) {
+        a.push_back(std::make_unique<int>(v));
+    }
+    for (int v: {2, 3}) {
+        b.push_back(std::make_unique<int>(v));
+    }
+    auto less = [](const std::unique_ptr<int>& x, const std::unique_ptr<int>& y) { return *x < *y; };
+    CCircularBufferMerge<CCircularBuffer<std::unique_ptr<int>>, decltype(less), true> merge({&a, &b}, less);
+
+    std::vector<std::unique_ptr<int>> out;
+    EXPECT_EQ(3, merge.drain_merged(std::back_inserter(out), 3));
+    EXPECT_EQ(2, a.size());
+    EXPECT_EQ(0, b.size());
+    EXPECT_EQ(2, merge.drain_merged(std::back_inserter(out), 10));
+    EXPECT_TRUE(a.empty());
+    std::vector<int> values;
+    for (auto& p: out) {
+        values.push_back(*p);
+    }
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4, 6}), values);
+}
+
+TEST(CircularBufferMerge, DegenerateTest) {
+    CCircularBufferMerge<const CCircularBuffer<int>> none({});
+    EXPECT_TRUE(none.empty());
+
+    const CCircularBuffer<int> one{1, 2, 3};
+    CCircularBufferMerge<const CCircularBuffer<int>> single({&one});
+    std::vector<int> out;
+    single.drain_merged(std::back_inserter(out));
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), out);
+}
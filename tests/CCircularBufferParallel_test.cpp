@@ -0,0 +1,110 @@
+#include "lib/CCircularBufferExt.h"
+#include "lib/CCircularBufferParallel.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Full buffer of n elements whose storage wraps at about a third.
+    CCircularBuffer<int> make_wrapped(size_t n) {
+        CCircularBuffer<int> a(n);
+        for (size_t i = 0; i < n; ++i) {
+            a.push_back(0);
+        }
+        std::mt19937 rng(5);
+        for (size_t i = 0; i < n + n / 3; ++i) {
+            a.pop_front();
+            a.push_back(static_cast<int>(rng() % 1'000'000));
+        }
+        return a;
+    }
+}
+
+TEST(CircularBufferParallel, SegmentsTest) {
+    CCircularBuffer<int> a(4);
+    EXPECT_TRUE(a.segments()[0].empty());
+    a.push_back(1);
+    a.push_back(2);
+    a.push_back(3);
+    a.pop_front();
+    a.push_back(4);
+    a.push_back(5);
+    auto segments = std::as_const(a).segments();
+    EXPECT_EQ(std::vector<int>({2, 3, 4}), std::vector<int>(segments[0].begin(), segments[0].end()));
+    EXPECT_EQ(std::vector<int>({5}), std::vector<int>(segments[1].begin(), segments[1].end()));
+
+    auto slice = ParallelChunks::slice(segments, 1, 4);
+    EXPECT_EQ(2, slice[0].size());
+    EXPECT_EQ(3, slice[0][0]);
+    EXPECT_EQ(1, slice[1].size());
+}
+
+TEST(CircularBufferParallel, AlgorithmsTest) {
+    constexpr size_t kn = 200'000;
+    CCircularBuffer<int> a = make_wrapped(kn);
+    ASSERT_FALSE(a.segments()[1].empty());
+    std::vector<int> expected(a.begin(), a.end());
+
+    for (size_t threads: {1, 4}) {
+        EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), int64_t(0)),
+                  parallel_reduce(a, int64_t(0), std::plus<>(), threads));
+
+        std::vector<int> doubled(kn);
+        parallel_transform(a, doubled.begin(), [](int x) { return 2 * x; }, threads);
+        for (size_t i = 0; i < kn; i += 997) {
+            ASSERT_EQ(2 * expected[i], doubled[i]);
+        }
+
+        auto it = std::find_if(expected.begin(), expected.end(), [](int x) { return x > 999'000; });
+        EXPECT_EQ(static_cast<size_t>(it - expected.begin()),
+                  parallel_find_if(a, [](int x) { return x > 999'000; }, threads));
+        EXPECT_EQ(kn, parallel_find_if(a, [](int x) { return x < 0; }, threads));
+    }
+
+    parallel_for_each(a, [](int& x) { ++x; }, 4);
+    EXPECT_EQ(expected[kn / 2] + 1, a[kn / 2]);
+
+    parallel_sort(a, std::less<>(), 3);
+    EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected.front() + 1, a.front());
+    EXPECT_EQ(expected.back() + 1, a.back());
+
+    CCircularBufferExt<int> b;
+    for (int i = 50'000; i > 0; --i) {
+        b.push_back(i);
+    }
+    parallel_sort(b, std::less<>(), 4);
+    EXPECT_TRUE(std::is_sorted(b.begin(), b.end()));
+    EXPECT_EQ(1, b.front());
+}
+
+TEST(CircularBufferParallel, PoolReuseTest) {
+    ParallelPool pool(4);
+    EXPECT_EQ(4, pool.concurrency());
+    std::vector<std::atomic<int>> hits(64);
+    for (int round = 0; round < 200; ++round) {
+        pool.run(hits.size(), [&](size_t i) { hits[i].fetch_add(1); });
+    }
+    for (auto& h: hits) {
+        EXPECT_EQ(200, h.load());
+    }
+
+    std::vector<std::thread> callers;
+    std::atomic<int> total{0};
+    for (int t = 0; t < 3; ++t) {
+        callers.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) {
+                pool.run(10, [&](size_t) { total.fetch_add(1); });
+            }
+        });
+    }
+    for (auto& caller: callers) {
+        caller.join();
+    }
+    EXPECT_EQ(3 * 50 * 10, total.load());
+}
@@ -0,0 +1,94 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CCircularBufferExt.h"
+#include "lib/CCompactCircularBuffer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+using Buffer = CCircularBuffer<int>;
+
+static_assert(std::random_access_iterator<Buffer::iterator>);
+static_assert(std::random_access_iterator<Buffer::const_iterator>);
+static_assert(std::sized_sentinel_for<Buffer::iterator, Buffer::iterator>);
+static_assert(std::ranges::random_access_range<Buffer>);
+static_assert(std::ranges::random_access_range<const Buffer>);
+static_assert(std::ranges::sized_range<Buffer>);
+static_assert(std::ranges::common_range<Buffer>);
+static_assert(std::ranges::random_access_range<CCircularBufferExt<int>>);
+static_assert(std::ranges::random_access_range<CCompactCircularBuffer<int>>);
+static_assert(!std::ranges::borrowed_range<Buffer>);
+static_assert(std::ranges::borrowed_range<decltype(std::declval<Buffer&>().view())>);
+static_assert(std::ranges::view<decltype(std::declval<const Buffer&>().view())>);
+static_assert(std::ranges::sized_range<decltype(std::declval<Buffer&>().view())>);
+
+// Buffer of capacity n holding values in order, wrapped around the end of its storage.
+Buffer make_wrapped(size_t n, const std::vector<int>& values) {
+    Buffer buffer(n);
+    for (size_t i = 0; i < n - values.size() / 2; ++i) {
+        buffer.push_back(0);
+        buffer.pop_front();
+    }
+    for (int v: values) {
+        buffer.push_back(v);
+    }
+    return buffer;
+}
+
+TEST(CircularBufferRanges, IteratorArithmeticTest) {
+    Buffer a = make_wrapped(8, {1, 2, 3, 4, 5, 6});
+    EXPECT_TRUE(std::ranges::equal(a, std::vector<int>{1, 2, 3, 4, 5, 6}));
+    EXPECT_FALSE(a.segments()[1].empty());
+
+    auto it = a.begin() + 4;
+    EXPECT_EQ(5, *it);
+    EXPECT_EQ(2, it[-3]);
+    EXPECT_EQ(4, it - a.begin());
+    EXPECT_EQ(a.end(), it + 2);
+    EXPECT_EQ(6, *std::prev(a.end()));
+    EXPECT_EQ(a.begin(), a.end() - 6);
+    EXPECT_TRUE(a.begin() < it && it < a.end());
+
+    Buffer::const_iterator c = it; // iterator converts to const_iterator
+    EXPECT_TRUE(c == it && it == c);
+    EXPECT_EQ(a.cend(), a.end());
+    a.insert(a.begin() + 1, 7);
+    EXPECT_TRUE(std::ranges::equal(a, std::vector<int>{1, 7, 2, 3, 4, 5, 6}));
+}
+
+TEST(CircularBufferRanges, AlgorithmsOnWrappedBufferTest) {
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    std::reverse(values.begin(), values.end());
+    Buffer a = make_wrapped(1500, values);
+
+    std::sort(a.begin(), a.end());
+    EXPECT_TRUE(std::is_sorted(a.begin(), a.end()));
+    std::ranges::sort(a, std::greater<>());
+    EXPECT_TRUE(std::ranges::equal(a, values));
+    EXPECT_EQ(std::ranges::lower_bound(a, 10, std::greater<>()) - a.begin(), 989);
+}
+
+TEST(CircularBufferRanges, ViewsTest) {
+    Buffer a = make_wrapped(6, {1, 2, 3, 4, 5});
+    auto even = a | std::views::filter([](int v) { return v % 2 == 0; })
+                  | std::views::transform([](int v) { return v * 10; });
+    EXPECT_TRUE(std::ranges::equal(even, std::vector<int>{20, 40}));
+    EXPECT_TRUE(std::ranges::equal(a | std::views::reverse | std::views::take(2), std::vector<int>{5, 4}));
+
+    auto joined = a.segments() | std::views::join;
+    EXPECT_TRUE(std::ranges::equal(joined, a));
+
+    // A borrowed range: the iterator outlives the temporary view.
+    auto found = std::ranges::find(a.view(), 3);
+    EXPECT_EQ(3, *found);
+    EXPECT_EQ(5u, a.view().size());
+
+    const Buffer& c = a;
+    int sum = 0;
+    for (int v: c.view() | std::views::drop(1)) {
+        sum += v;
+    }
+    EXPECT_EQ(14, sum);
+}
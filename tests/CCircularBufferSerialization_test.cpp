@@ -0,0 +1,157 @@
+#include "lib/CCircularBuffer.h"
+#include "lib/CCircularBufferExt.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct VectorWriter {
+    std::vector<std::byte>* out;
+    size_t* calls;
+
+    void operator()(const void* data, size_t size) const {
+        auto bytes = static_cast<const std::byte*>(data);
+        out->insert(out->end(), bytes, bytes + size);
+        ++*calls;
+    }
+};
+
+struct VectorReader {
+    const std::vector<std::byte>* in;
+    size_t offset = 0;
+
+    void operator()(void* data, size_t size) {
+        if (in->size() - offset < size) {
+            throw std::runtime_error("short read");
+        }
+        std::memcpy(data, in->data() + offset, size);
+        offset += size;
+    }
+};
+
+struct StringSerializer {
+    static void serialize(const std::string& value, std::vector<std::byte>& out) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        auto header = reinterpret_cast<const std::byte*>(&length);
+        out.insert(out.end(), header, header + sizeof(length));
+        auto bytes = reinterpret_cast<const std::byte*>(value.data());
+        out.insert(out.end(), bytes, bytes + value.size());
+    }
+
+    static size_t deserialize(std::span<const std::byte> data, std::string& out) {
+        uint32_t length = 0;
+        if (data.size() < sizeof(length)) {
+            return 0;
+        }
+        std::memcpy(&length, data.data(), sizeof(length));
+        if (data.size() - sizeof(length) < length) {
+            return 0;
+        }
+        out.assign(reinterpret_cast<const char*>(data.data()) + sizeof(length), length);
+        return sizeof(length) + length;
+    }
+};
+
+struct OtherStringSerializer : StringSerializer {};
+
+}
+
+TEST(CircularBufferSerialization, RawSegmentsRoundTripTest) {
+    CCircularBuffer<uint64_t> a(8);
+    for (uint64_t i = 0; i < 13; ++i) {
+        if (a.size() == a.capacity()) {
+            a.pop_front();
+        }
+        a.push_back(i * i);
+    }
+    ASSERT_FALSE(a.segments()[1].empty());
+
+    std::vector<std::byte> bytes;
+    size_t calls = 0;
+    a.serialize(VectorWriter{&bytes, &calls});
+    EXPECT_EQ(3, calls); // header and two segments
+    EXPECT_EQ(sizeof(CircularBufferHeader) + 8 * sizeof(uint64_t), bytes.size());
+
+    CCircularBuffer<uint64_t> b(8);
+    b.push_back(1);
+    const uint64_t* storage = b.segments()[0].data();
+    b.deserialize(VectorReader{&bytes});
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(8, b.capacity());
+    EXPECT_EQ(storage, b.segments()[0].data()); // same capacity, no reallocation
+    EXPECT_TRUE(b.segments()[1].empty());       // restored in linear order
+
+    CCircularBuffer<uint64_t> c;
+    c.deserialize(VectorReader{&bytes});
+    EXPECT_TRUE(a == c);
+    EXPECT_THROW(c.push_back(0), FullBufferException);
+}
+
+TEST(CircularBufferSerialization, ExtAndEmptyTest) {
+    CCircularBufferExt<int> a;
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(i);
+    }
+    std::vector<std::byte> bytes;
+    size_t calls = 0;
+    a.serialize(VectorWriter{&bytes, &calls});
+
+    CCircularBufferExt<int> b;
+    b.deserialize(VectorReader{&bytes});
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+    b.push_back(100); // still grows
+    EXPECT_EQ(101, b.size());
+
+    CCircularBuffer<int> empty(4);
+    bytes.clear();
+    empty.serialize(VectorWriter{&bytes, &calls});
+    b.deserialize(VectorReader{&bytes});
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(4, b.capacity());
+}
+
+TEST(CircularBufferSerialization, CustomSerializerTest) {
+    CCircularBuffer<std::string> a(3);
+    a.push_back("first");
+    a.push_back(std::string(100'000, 'x')); // larger than one block
+    a.push_back("");
+    a.pop_front();
+    a.push_back("last");
+
+    std::vector<std::byte> bytes;
+    size_t calls = 0;
+    a.serialize<StringSerializer>(VectorWriter{&bytes, &calls});
+
+    CCircularBuffer<std::string> b(1);
+    b.push_back("old");
+    b.deserialize<StringSerializer>(VectorReader{&bytes});
+    EXPECT_TRUE(a == b);
+
+    // Another serializer does not accept the stream.
+    EXPECT_THROW(b.deserialize<OtherStringSerializer>(VectorReader{&bytes}), std::runtime_error);
+}
+
+TEST(CircularBufferSerialization, RejectsMismatchTest) {
+    CCircularBuffer<uint32_t> a(4);
+    a.push_back(7);
+    std::vector<std::byte> bytes;
+    size_t calls = 0;
+    a.serialize(VectorWriter{&bytes, &calls});
+
+    CCircularBuffer<uint64_t> wrong_type(4);
+    EXPECT_THROW(wrong_type.deserialize(VectorReader{&bytes}), std::runtime_error);
+
+    CCircularBuffer<float> same_size(4); // checked by type, not only by element size
+    EXPECT_THROW(same_size.deserialize(VectorReader{&bytes}), std::runtime_error);
+
+    bytes[0] = std::byte{'X'};
+    CCircularBuffer<uint32_t> b(4);
+    EXPECT_THROW(b.deserialize(VectorReader{&bytes}), std::runtime_error);
+
+    bytes[0] = std::byte{'C'};
+    bytes.pop_back();
+    EXPECT_THROW(b.deserialize(VectorReader{&bytes}), std::runtime_error); // short read
+}
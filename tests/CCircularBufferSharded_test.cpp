@@ -0,0 +1,94 @@
+#include "lib/CCircularBufferSharded.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+TEST(ShardedCircularBuffer, DrainAllTest) {
+    const size_t kthreads = 4;
+    const int kper_thread = 1000;
+    CCircularBufferSharded<int> a(kper_thread);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kthreads; ++t) {
+        threads.emplace_back([&a, t] {
+            for (int i = 0; i < kper_thread; ++i) {
+                a.push_back(static_cast<int>(t) * kper_thread + i);
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(kthreads, a.shard_count());
+
+    std::vector<int> out;
+    EXPECT_EQ(kthreads * kper_thread, a.drain_all(std::back_inserter(out)));
+    std::sort(out.begin(), out.end());
+    for (int i = 0; i < static_cast<int>(out.size()); ++i) {
+        EXPECT_EQ(i, out[i]);
+    }
+    EXPECT_EQ(0, a.shard_count());
+}
+
+TEST(ShardedCircularBuffer, MergeBySequenceTest) {
+    CCircularBufferSharded<uint64_t> a(256);
+    std::atomic<uint64_t> sequence{0};
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 3; ++t) {
+        threads.emplace_back([&a, &sequence] {
+            for (int i = 0; i < 200; ++i) {
+                a.push_back(sequence.fetch_add(1));
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> out;
+    a.drain_all(std::back_inserter(out), std::less<uint64_t>());
+    EXPECT_EQ(600, out.size());
+    EXPECT_TRUE(std::is_sorted(out.begin(), out.end()));
+}
+
+TEST(ShardedCircularBuffer, OverwriteOldestTest) {
+    CCircularBufferSharded<int> a(2);
+    a.push_back(1);
+    a.push_back(2);
+    a.push_back(3);
+    EXPECT_EQ(1, a.dropped());
+
+    size_t total = 0;
+    a.for_each_shard([&total](const CCircularBuffer<int>& shard) {
+        total += shard.size();
+        EXPECT_EQ(2, shard.front());
+    });
+    EXPECT_EQ(2, total);
+}
+
+TEST(ShardedCircularBuffer, ZeroShardCapacityTest) {
+    EXPECT_THROW(CCircularBufferSharded<int>(0), std::invalid_argument);
+}
+
+TEST(ShardedCircularBuffer, EmplaceInPlaceTest) {
+    struct Pinned {
+        Pinned(int a, int b) : sum(a + b) {}
+
+        Pinned(const Pinned&) = delete;
+
+        int sum;
+    };
+
+    CCircularBufferSharded<Pinned> a(2);
+    a.emplace_back(1, 2);
+    a.emplace_back(3, 4);
+    a.emplace_back(5, 6);
+    EXPECT_EQ(1, a.dropped());
+    a.for_each_shard([](const CCircularBuffer<Pinned>& shard) {
+        ASSERT_EQ(2, shard.size());
+        EXPECT_EQ(7, shard.front().sum);
+        EXPECT_EQ(11, shard.back().sum);
+    });
+}
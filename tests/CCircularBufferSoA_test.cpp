@@ -0,0 +1,105 @@
+#include "lib/CCircularBufferSoA.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+
+using Tick = CCircularBufferSoA<double, int64_t, std::string>;
+
+static_assert(std::random_access_iterator<Tick::iterator>);
+static_assert(std::random_access_iterator<Tick::const_iterator>);
+static_assert(std::ranges::random_access_range<Tick>);
+
+TEST(SoACircularBuffer, PushPopTest) {
+    Tick a(3);
+    a.push_back(1.5, 10, "a");
+    a.push_back(2.5, 20, "b");
+    a.push_front(0.5, 0, "z");
+    EXPECT_THROW(a.push_back(3.5, 30, "c"), FullBufferException);
+    EXPECT_EQ(3, a.size());
+    EXPECT_EQ(0.5, a.get<0>(0));
+    EXPECT_EQ("b", a.get<2>(2));
+
+    a.pop_front();
+    a.push_back(3.5, 30, "c");
+    EXPECT_EQ(Tick::value_type(1.5, 10, "a"), Tick::value_type(a.front()));
+    EXPECT_EQ(Tick::value_type(3.5, 30, "c"), Tick::value_type(a.back()));
+    a.pop_back();
+    a.pop_back();
+    a.pop_back();
+    EXPECT_THROW(a.pop_back(), EmptyBufferException);
+}
+
+TEST(SoACircularBuffer, ColumnSegmentsTest) {
+    CCircularBufferSoA<double, int> a(4);
+    for (int i = 0; i < 4; ++i) {
+        a.push_back(i * 1.0, i);
+    }
+    a.pop_front();
+    a.pop_front();
+    a.push_back(4.0, 4);
+
+    auto segments = a.column_segments<1>();
+    EXPECT_EQ(2, segments[0].size());
+    EXPECT_EQ(1, segments[1].size());
+    EXPECT_EQ(2, segments[0][0]);
+    EXPECT_EQ(4, segments[1][0]);
+
+    int sum = 0;
+    for (auto segment: segments) {
+        sum = std::accumulate(segment.begin(), segment.end(), sum);
+    }
+    EXPECT_EQ(2 + 3 + 4, sum);
+}
+
+TEST(SoACircularBuffer, IteratorSortTest) {
+    CCircularBufferSoA<int, char> a(5);
+    a.push_back(3, 'c');
+    a.push_back(1, 'a');
+    a.push_back(2, 'b');
+    a.pop_front();
+    a.push_back(5, 'e');
+    a.push_back(4, 'd');
+    a.push_back(3, 'c');
+
+    std::sort(a.begin(), a.end(), [](const std::tuple<int, char>& x, const std::tuple<int, char>& y) {
+        return std::get<0>(x) < std::get<0>(y);
+    });
+    std::string letters;
+    for (auto r: a) {
+        letters += r.get<1>();
+    }
+    EXPECT_EQ("abcde", letters);
+    EXPECT_EQ(5, a.end() - a.begin());
+    EXPECT_EQ('d', a.begin()[3].get<1>());
+}
+
+struct LiveCounter {
+    static inline int live = 0;
+
+    LiveCounter() { ++live; }
+
+    LiveCounter(const LiveCounter&) { ++live; }
+
+    ~LiveCounter() { --live; }
+};
+
+struct ThrowOnCopy {
+    ThrowOnCopy() = default;
+
+    ThrowOnCopy(const ThrowOnCopy&) { throw std::runtime_error("copy"); }
+};
+
+TEST(SoACircularBuffer, FieldConstructorThrowsTest) {
+    CCircularBufferSoA<LiveCounter, ThrowOnCopy> a(2);
+    {
+        LiveCounter counter;
+        ThrowOnCopy thrower;
+        EXPECT_THROW(a.push_back(counter, thrower), std::runtime_error);
+        EXPECT_THROW(a.push_front(counter, thrower), std::runtime_error);
+    }
+    EXPECT_EQ(0, LiveCounter::live);
+    EXPECT_TRUE(a.empty());
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 TEST(CircularContainer, EmptyConstructorTest) {
     CCircularBuffer<std::string> b;
@@ -258,3 +259,115 @@ TEST(ExtendedCircularSequenceContainer, DoubleUpTest) {
 
     EXPECT_EQ(a, b);
 }
+
+TEST(CircularSequenceContainer, TryPushPopTest) {
+    CCircularBuffer<std::string> a(2);
+    EXPECT_TRUE(a.try_push_back("a"));
+    std::string s = "b";
+    EXPECT_TRUE(a.try_emplace_back(s));
+    EXPECT_FALSE(a.try_push_back("c"));
+    EXPECT_FALSE(a.try_emplace_back(3, 'c'));
+    EXPECT_EQ(2, a.size());
+
+    EXPECT_EQ("a", a.try_pop_front());
+    EXPECT_TRUE(a.try_pop_front(s));
+    EXPECT_EQ("b", s);
+    EXPECT_EQ(std::nullopt, a.try_pop_front());
+    EXPECT_FALSE(a.try_pop_front(s));
+}
+
+TEST(ExtendedCircularSequenceContainer, TryPushBackGrowsTest) {
+    CCircularBufferExt<int> a;
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_TRUE(a.try_push_back(i));
+    }
+    EXPECT_TRUE(a.try_emplace_back(5));
+    EXPECT_EQ(6, a.size());
+    EXPECT_EQ(0, a.try_pop_front());
+}
+
+struct CopyCounter {
+    static inline int copies = 0;
+    static inline int constructions = 0;
+
+    explicit CopyCounter(std::string s) : payload(std::move(s)) { ++constructions; }
+
+    CopyCounter(const CopyCounter& other) : payload(other.payload) { ++copies; }
+
+    CopyCounter(CopyCounter&& other) noexcept = default;
+
+    CopyCounter& operator=(const CopyCounter& other) {
+        payload = other.payload;
+        ++copies;
+        return *this;
+    }
+
+    CopyCounter& operator=(CopyCounter&& other) noexcept = default;
+
+    std::string payload;
+};
+
+TEST(CircularSequenceContainer, NoHiddenCopiesTest) {
+    CopyCounter::copies = 0;
+    CopyCounter::constructions = 0;
+    CCircularBuffer<CopyCounter> a(8);
+    a.emplace_back("b");
+    a.emplace_front("a");
+    a.emplace(a.cbegin() + 1, "x");
+    a.push_back(CopyCounter("d"));
+    a.insert(a.cbegin() + 3, CopyCounter("c"));
+    a.erase(a.cbegin() + 1);
+    a.pop_front();
+    a.push_back(CopyCounter("e"));
+
+    EXPECT_EQ(0, CopyCounter::copies);
+    EXPECT_EQ(6, CopyCounter::constructions);
+    std::string s;
+    for (auto& c: a) {
+        s += c.payload;
+    }
+    EXPECT_EQ("bcde", s);
+}
+
+TEST(ExtendedCircularSequenceContainer, NoHiddenCopiesTest) {
+    CopyCounter::copies = 0;
+    CCircularBufferExt<CopyCounter> a;
+    for (int i = 0; i < 10; ++i) {
+        a.push_back(CopyCounter(std::to_string(i)));
+        a.emplace_front(std::to_string(i));
+        a.insert(a.cbegin() + 1, CopyCounter("i"));
+    }
+    EXPECT_EQ(0, CopyCounter::copies);
+    EXPECT_EQ(30, a.size());
+    EXPECT_EQ("9", a.front().payload);
+    EXPECT_EQ("9", a.back().payload);
+}
+
+TEST(CircularSequenceContainer, MoveOnlyTest) {
+    CCircularBufferExt<std::unique_ptr<int>> a;
+    a.push_back(std::make_unique<int>(2));
+    a.emplace_front(new int(0));
+    a.emplace(a.cbegin() + 1, new int(1));
+    a.insert(a.cend(), std::make_unique<int>(3));
+    a.erase(a.cbegin());
+    EXPECT_EQ(3, a.size());
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(i + 1, *a[i]);
+    }
+    std::optional<std::unique_ptr<int>> p = a.try_pop_front();
+    EXPECT_EQ(1, **p);
+}
+
+TEST(ExtendedCircularSequenceContainer, DoubleUpWrappedTest) {
+    CCircularBufferExt<int> a(4);
+    for (int i = 0; i < 4; ++i) {
+        a.push_back(i);
+    }
+    a.pop_front();
+    a.pop_front();
+    a.push_back(4);
+    a.push_back(5);
+    a.push_back(6);
+    CCircularBuffer<int> b{2, 3, 4, 5, 6};
+    EXPECT_EQ(b, a);
+}
@@ -0,0 +1,79 @@
+#include "lib/CCircularRecordBuffer.h"
+#include <gtest/gtest.h>
+#include <deque>
+#include <random>
+#include <string>
+
+namespace {
+    std::span<const std::byte> bytes_of(const std::string& s) {
+        return std::as_bytes(std::span<const char>(s.data(), s.size()));
+    }
+
+    std::string string_of(std::span<const std::byte> record) {
+        return {reinterpret_cast<const char*>(record.data()), record.size()};
+    }
+}
+
+TEST(CircularRecordBuffer, ReserveCommitTest) {
+    CCircularRecordBuffer<> a(64);
+    std::span<std::byte> record = a.reserve(10);
+    ASSERT_EQ(10, record.size());
+    std::memcpy(record.data(), "0123456789", 10);
+    EXPECT_TRUE(a.empty());
+    a.commit(4);
+    EXPECT_EQ(1, a.size());
+    EXPECT_EQ("0123", string_of(a.front_record()));
+    EXPECT_EQ(16, a.bytes_used());
+    a.pop_record();
+    EXPECT_TRUE(a.empty());
+    EXPECT_THROW(a.pop_record(), EmptyBufferException);
+}
+
+TEST(CircularRecordBuffer, FailedReserveDropsReservationTest) {
+    CCircularRecordBuffer<> a(64);
+    std::span<std::byte> record = a.reserve(8);
+    ASSERT_EQ(8, record.size());
+    EXPECT_EQ(nullptr, a.reserve(100).data());
+    a.commit(); // nothing is reserved any more
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0, a.bytes_used());
+}
+
+TEST(CircularRecordBuffer, FullTest) {
+    CCircularRecordBuffer<> a(64);
+    EXPECT_TRUE(a.push(bytes_of(std::string(20, 'a'))));
+    EXPECT_TRUE(a.push(bytes_of(std::string(20, 'b'))));
+    EXPECT_FALSE(a.push(bytes_of(std::string(1, 'c'))));
+    EXPECT_EQ(nullptr, a.reserve(100).data());
+    a.pop_record();
+    EXPECT_TRUE(a.push(bytes_of(std::string(8, 'c'))));
+    EXPECT_EQ(std::string(20, 'b'), string_of(a.front_record()));
+}
+
+TEST(CircularRecordBuffer, WrapAroundTest) {
+    CCircularRecordBuffer<> a(1000);
+    std::deque<std::string> model;
+    std::mt19937 random(3);
+    for (int i = 0; i < 10'000; ++i) {
+        if (random() % 2 == 0) {
+            std::string s(random() % 200, static_cast<char>('a' + i % 26));
+            if (a.push(bytes_of(s))) {
+                model.push_back(s);
+            } else {
+                ASSERT_FALSE(model.empty());
+            }
+        } else if (!model.empty()) {
+            ASSERT_EQ(model.front(), string_of(a.front_record()));
+            a.pop_record();
+            model.pop_front();
+        }
+        ASSERT_EQ(model.size(), a.size());
+        ASSERT_LE(a.bytes_used(), a.capacity());
+    }
+    while (!model.empty()) {
+        EXPECT_EQ(model.front(), string_of(a.front_record()));
+        a.pop_record();
+        model.pop_front();
+    }
+    EXPECT_EQ(0, a.bytes_used());
+}
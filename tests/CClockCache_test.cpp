@@ -0,0 +1,63 @@
+#include "lib/CClockCache.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(ClockCache, PutFindTest) {
+    CClockCache<int, std::string> a(3);
+    a.put(1, "a");
+    a.put(2, "b");
+    a.put(3, "c");
+    EXPECT_EQ(3, a.size());
+    ASSERT_NE(nullptr, a.find(2));
+    EXPECT_EQ("b", *a.find(2));
+    EXPECT_EQ(nullptr, a.find(4));
+
+    a.put(2, "B");
+    EXPECT_EQ("B", *a.find(2));
+    EXPECT_EQ(3, a.size());
+}
+
+TEST(ClockCache, SecondChanceEvictionTest) {
+    CClockCache<int, int> a(3);
+    a.put(1, 10);
+    a.put(2, 20);
+    a.put(3, 30);
+    a.find(1);
+    a.find(3);
+
+    a.put(4, 40);
+    EXPECT_FALSE(a.contains(2));
+    EXPECT_TRUE(a.contains(1));
+    EXPECT_TRUE(a.contains(3));
+    EXPECT_TRUE(a.contains(4));
+
+    a.put(5, 50);
+    EXPECT_FALSE(a.contains(1));
+    EXPECT_EQ(3, a.size());
+}
+
+TEST(ClockCache, ManyKeysTest) {
+    const int kcapacity = 100;
+    CClockCache<int, int> a(kcapacity);
+    for (int i = 0; i < 10000; ++i) {
+        a.put(i, i * 2);
+        ASSERT_NE(nullptr, a.find(i));
+        EXPECT_EQ(i * 2, *a.find(i));
+    }
+    int present = 0;
+    for (int i = 0; i < 10000; ++i) {
+        present += a.contains(i);
+    }
+    EXPECT_EQ(kcapacity, present);
+}
+
+TEST(ClockCache, CapacityBoundsTest) {
+    using Cache = CClockCache<int, int>;
+    EXPECT_THROW(Cache(0), std::invalid_argument);
+    EXPECT_THROW(Cache(size_t(UINT32_MAX)), std::length_error);
+    Cache one(1);
+    one.put(1, 10);
+    one.put(2, 20);
+    EXPECT_EQ(nullptr, one.find(1));
+    EXPECT_EQ(20, *one.find(2));
+}
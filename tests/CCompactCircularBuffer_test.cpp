@@ -0,0 +1,71 @@
+#include "lib/CCompactCircularBuffer.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+static_assert(sizeof(CCompactCircularBuffer<int>) == 24);
+static_assert(sizeof(CCompactCircularBuffer<int, uint16_t>) == 16);
+static_assert(sizeof(CCompactCircularBuffer<int, uint8_t>) == 16);
+
+TEST(CompactCircularBuffer, PushPopTest) {
+    CCompactCircularBuffer<int, uint16_t> a(3);
+    a.push_back(1);
+    a.push_back(2);
+    a.push_front(0);
+    EXPECT_THROW(a.push_back(3), FullBufferException);
+    EXPECT_FALSE(a.try_push_back(3));
+    EXPECT_EQ(0, a.front());
+    EXPECT_EQ(2, a.back());
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), std::vector<int>(a.begin(), a.end()));
+
+    a.pop_front();
+    a.push_back(3);
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), std::vector<int>(a.cbegin(), a.cend()));
+    a.pop_back();
+    EXPECT_EQ(1, a.try_pop_front());
+    EXPECT_EQ(2, a[0]);
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_THROW(a.pop_front(), EmptyBufferException);
+}
+
+TEST(CompactCircularBuffer, IndexLimitTest) {
+    CCompactCircularBuffer<int, uint8_t> a(255);
+    EXPECT_EQ(255, a.max_size());
+    EXPECT_THROW((CCompactCircularBuffer<int, uint8_t>(256)), std::length_error);
+
+    for (int i = 0; i < 1000; ++i) {
+        if (a.full()) {
+            a.pop_front();
+        }
+        a.push_back(i);
+    }
+    EXPECT_EQ(255, a.size());
+    for (size_t k = 0; k < a.size(); ++k) {
+        ASSERT_EQ(745 + static_cast<int>(k), a[k]);
+    }
+    EXPECT_EQ(999, a.back());
+}
+
+TEST(CompactCircularBuffer, CopyMoveTest) {
+    CCompactCircularBuffer<std::unique_ptr<int>, uint16_t> a(2);
+    a.emplace_back(std::make_unique<int>(1));
+    a.emplace_front(std::make_unique<int>(0));
+    CCompactCircularBuffer<std::unique_ptr<int>, uint16_t> b(std::move(a));
+    EXPECT_EQ(0, a.capacity());
+    EXPECT_EQ(1, *b.back());
+    std::unique_ptr<int> p;
+    EXPECT_TRUE(b.try_pop_front(p));
+    EXPECT_EQ(0, *p);
+
+    CCompactCircularBuffer<int> c(4);
+    c.push_back(5);
+    c.push_back(6);
+    CCompactCircularBuffer<int> d = c;
+    c.pop_front();
+    EXPECT_EQ(2, d.size());
+    EXPECT_EQ(5, d.front());
+    d = c;
+    EXPECT_EQ(1, d.size());
+    EXPECT_EQ(6, d.front());
+}
@@ -0,0 +1,60 @@
+#include "lib/CCompressedCircularBuffer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+TEST(CompressedCircularBuffer, RoundTripTest) {
+    CCompressedCircularBuffer<int64_t> a(1000, 64);
+    std::vector<int64_t> values;
+    int64_t v = 1'000'000'000;
+    for (int i = 0; i < 500; ++i) {
+        v += (i % 7) - 3;
+        values.push_back(v);
+        a.push_back(v);
+    }
+    values.push_back(std::numeric_limits<int64_t>::min());
+    a.push_back(std::numeric_limits<int64_t>::min());
+    values.push_back(std::numeric_limits<int64_t>::max());
+    a.push_back(std::numeric_limits<int64_t>::max());
+
+    EXPECT_EQ(values.size(), a.size());
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), a.begin(), a.end()));
+    EXPECT_EQ(values[137], a[137]);
+    EXPECT_EQ(values.back(), a.back());
+    EXPECT_EQ(values.front(), a.front());
+    EXPECT_TRUE(a.seek(a.size()) == a.end());
+}
+
+TEST(CompressedCircularBuffer, EvictWholeBlocksTest) {
+    const size_t kcapacity = 256;
+    const size_t kblock = 32;
+    CCompressedCircularBuffer<int32_t> a(kcapacity, kblock);
+    std::deque<int32_t> values;
+    for (int32_t i = 0; i < 10'000; ++i) {
+        a.push_back(i * 3);
+        values.push_back(i * 3);
+        ASSERT_GE(a.size(), std::min<size_t>(i + 1, kcapacity));
+        ASSERT_LE(a.size(), kcapacity + kblock);
+    }
+    EXPECT_EQ(0, a.first_index() % kblock);
+    values.erase(values.begin(), values.end() - a.size());
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), a.begin(), a.end()));
+    EXPECT_EQ(values[100], a[100]);
+}
+
+TEST(CompressedCircularBuffer, CompressionTest) {
+    const size_t kcapacity = 100'000;
+    CCompressedCircularBuffer<int64_t> a(kcapacity);
+    int64_t v = 0;
+    for (size_t i = 0; i < kcapacity; ++i) {
+        v += i % 50;
+        a.push_back(v);
+    }
+    EXPECT_LT(a.memory_usage() * 5, kcapacity * sizeof(int64_t));
+}
+
+TEST(CompressedCircularBuffer, ZeroBlockSamplesTest) {
+    EXPECT_THROW(CCompressedCircularBuffer<int64_t>(100, 0), std::invalid_argument);
+}
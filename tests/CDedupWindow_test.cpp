@@ -0,0 +1,49 @@
+#include "lib/CDedupWindow.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+
+TEST(DedupWindow, InsertIfAbsentMatchesLinearScanTest) {
+    CDedupWindow<uint64_t> a(64);
+    std::deque<uint64_t> reference;
+    std::mt19937_64 rng(2);
+    for (int i = 0; i < 20'000; ++i) {
+        uint64_t id = rng() % 200;
+        bool seen = std::find(reference.begin(), reference.end(), id) != reference.end();
+        ASSERT_EQ(seen, a.contains(id));
+        ASSERT_EQ(!seen, a.insert_if_absent(id));
+        if (!seen) {
+            if (reference.size() == 64) {
+                reference.pop_front();
+            }
+            reference.push_back(id);
+        }
+        ASSERT_EQ(reference.size(), a.size());
+    }
+    EXPECT_TRUE(std::equal(reference.begin(), reference.end(), a.keys().begin()));
+}
+
+TEST(DedupWindow, DuplicateCountingTest) {
+    CDedupWindow<std::string> a(3);
+    a.push("x");
+    a.push("y");
+    a.push("x");
+    EXPECT_EQ(2, a.count("x"));
+    EXPECT_FALSE(a.insert_if_absent("x"));
+
+    a.push("z"); // evicts the first "x"
+    EXPECT_EQ(1, a.count("x"));
+    EXPECT_TRUE(a.contains("x"));
+    a.pop_front(); // "y"
+    a.pop_front(); // second "x"
+    EXPECT_FALSE(a.contains("x"));
+    EXPECT_TRUE(a.contains("z"));
+    EXPECT_TRUE(a.insert_if_absent("x"));
+
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(a.contains("z"));
+    EXPECT_THROW(a.pop_front(), EmptyBufferException);
+}
@@ -0,0 +1,108 @@
+#include "lib/CFlightRecorder.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace {
+    std::vector<std::byte> read_fd(int fd) {
+        std::vector<std::byte> bytes;
+        lseek(fd, 0, SEEK_SET);
+        std::byte chunk[4096];
+        ssize_t n;
+        while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+            bytes.insert(bytes.end(), chunk, chunk + n);
+        }
+        return bytes;
+    }
+}
+
+TEST(FlightRecorder, DumpKeepsLastEventsPerThreadTest) {
+    CFlightRecorder recorder(8);
+    EXPECT_EQ(8, recorder.events_per_thread());
+    for (uint64_t i = 0; i < 20; ++i) {
+        recorder.record(1, i, 2 * i);
+    }
+    std::thread other([&recorder] {
+        for (uint64_t i = 0; i < 3; ++i) {
+            recorder.record(2, i);
+        }
+    });
+    other.join();
+    EXPECT_EQ(2, recorder.threads());
+
+    int fd = memfd_create("flight_test", 0);
+    ASSERT_GE(fd, 0);
+    ASSERT_TRUE(recorder.dump(fd));
+    auto recording = parse_flight_dump(read_fd(fd));
+    close(fd);
+    ASSERT_TRUE(recording.has_value());
+
+    ASSERT_EQ(2, recording->threads.size());
+    EXPECT_EQ(20, recording->threads[0].written);
+    EXPECT_EQ(8, recording->threads[0].count);
+    EXPECT_EQ(3, recording->threads[1].count);
+    ASSERT_EQ(11, recording->events.size());
+
+    std::vector<uint64_t> main_args;
+    for (const FlightEvent& event: recording->events) {
+        if (event.code == 1) {
+            EXPECT_EQ(2 * event.args[0], event.args[1]);
+            main_args.push_back(event.args[0]);
+        }
+    }
+    EXPECT_EQ(std::vector<uint64_t>({12, 13, 14, 15, 16, 17, 18, 19}), main_args);
+    for (size_t i = 1; i < recording->events.size(); ++i) {
+        EXPECT_LE(recording->events[i - 1].timestamp, recording->events[i].timestamp);
+    }
+}
+
+TEST(FlightRecorder, RejectsMalformedDumpTest) {
+    std::vector<std::byte> garbage(64, std::byte{7});
+    EXPECT_FALSE(parse_flight_dump(garbage).has_value());
+
+    CFlightRecorder recorder(4);
+    recorder.record(1);
+    int fd = memfd_create("flight_test", 0);
+    ASSERT_TRUE(recorder.dump(fd));
+    std::vector<std::byte> bytes = read_fd(fd);
+    close(fd);
+    bytes.resize(bytes.size() - 1);
+    EXPECT_FALSE(parse_flight_dump(bytes).has_value());
+}
+
+TEST(FlightRecorder, CrashHandlerDumpsOnAbortTest) {
+    std::string path = testing::TempDir() + "flight_" + std::to_string(getpid()) + ".bin";
+    std::remove(path.c_str());
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        CFlightRecorder recorder(16);
+        if (!recorder.install_crash_handler(path.c_str())) {
+            _exit(3);
+        }
+        for (uint64_t i = 0; i < 5; ++i) {
+            recorder.record(42, i);
+        }
+        std::abort();
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(SIGABRT, WTERMSIG(status));
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto recording = parse_flight_dump(std::as_bytes(std::span<const char>(bytes)));
+    ASSERT_TRUE(recording.has_value());
+    ASSERT_EQ(5, recording->events.size());
+    EXPECT_EQ(42, recording->events.back().code);
+    EXPECT_EQ(4, recording->events.back().args[0]);
+    std::remove(path.c_str());
+}
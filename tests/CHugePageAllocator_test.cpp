@@ -0,0 +1,57 @@
+#include "lib/CCircularBufferExt.h"
+#include "lib/CHugePageAllocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+TEST(HugePageAllocator, LargeBufferTest) {
+    const size_t kcapacity = 3 * 1024 * 1024;
+    CCircularBuffer<int, CHugePageAllocator<int>> a(kcapacity);
+    for (size_t i = 0; i < kcapacity; ++i) {
+        a.push_back(static_cast<int>(i));
+    }
+    a.pop_front();
+    a.push_back(-1);
+    EXPECT_EQ(1, a.front());
+    EXPECT_EQ(-1, a.back());
+    EXPECT_EQ(12345, a[12344]);
+}
+
+TEST(HugePageAllocator, PrefaultTest) {
+    const size_t kcapacity = 1024 * 1024;
+    CCircularBuffer<int64_t, CHugePageAllocator<int64_t, HugePagePrefault::populate>> a(kcapacity);
+    CCircularBuffer<int64_t, CHugePageAllocator<int64_t, HugePagePrefault::touch, true>> b(kcapacity);
+    for (size_t i = 0; i < kcapacity; ++i) {
+        a.push_back(static_cast<int64_t>(i));
+        b.push_back(static_cast<int64_t>(i));
+    }
+    EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin()));
+}
+
+TEST(HugePageAllocator, SmallAndGrowingTest) {
+    CCircularBufferExt<std::string, CHugePageAllocator<std::string>> a;
+    for (int i = 0; i < 200'000; ++i) {
+        a.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(200'000, a.size());
+    EXPECT_EQ("199999", a.back());
+}
+
+TEST(HugePageAllocator, AlignmentTest) {
+    CHugePageAllocator<char> allocator;
+    const size_t khuge = allocator.khuge_page_size;
+    for (size_t bytes : {khuge, khuge + 1, 3 * khuge + 4096}) {
+        char* p = allocator.allocate(bytes);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % khuge);
+        p[0] = 1;
+        p[bytes - 1] = 1;
+        allocator.deallocate(p, bytes);
+    }
+}
+
+TEST(HugePageAllocator, OverflowTest) {
+    CHugePageAllocator<int64_t> allocator;
+    EXPECT_THROW((void)allocator.allocate(allocator.max_size() + 1), std::bad_alloc);
+    EXPECT_THROW((void)allocator.allocate(std::numeric_limits<size_t>::max() / 4), std::bad_alloc);
+}
@@ -0,0 +1,62 @@
+#include "lib/CSeqlockCircularBuffer.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Quote {
+        uint64_t sequence;
+        uint64_t bid;
+        uint64_t ask;
+    };
+}
+
+TEST(SeqlockCircularBuffer, ReadLatestTest) {
+    CSeqlockCircularBuffer<Quote> a(4);
+    Quote out[8];
+    EXPECT_EQ(0, a.read_latest(8, out));
+    EXPECT_FALSE(a.read_latest(out[0]));
+
+    for (uint64_t i = 0; i < 6; ++i) {
+        a.push_back({i, 2 * i, 3 * i});
+    }
+    EXPECT_EQ(4, a.size());
+    EXPECT_EQ(4, a.read_latest(8, out));
+    EXPECT_EQ(2, out[0].sequence);
+    EXPECT_EQ(5, out[3].sequence);
+    EXPECT_TRUE(a.read_latest(out[0]));
+    EXPECT_EQ(10, out[0].bid);
+
+    EXPECT_FALSE(a.read(1, out[0]));
+    EXPECT_FALSE(a.read(6, out[0]));
+    EXPECT_TRUE(a.read(3, out[0]));
+    EXPECT_EQ(9, out[0].ask);
+}
+
+TEST(SeqlockCircularBuffer, ConcurrentReadersTest) {
+    CSeqlockCircularBuffer<Quote> a(64);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            Quote out[16];
+            while (!done.load()) {
+                size_t n = a.read_latest(16, out);
+                for (size_t i = 0; i < n; ++i) {
+                    ASSERT_EQ(2 * out[i].sequence, out[i].bid);
+                    ASSERT_EQ(3 * out[i].sequence, out[i].ask);
+                    if (i > 0) {
+                        ASSERT_EQ(out[i - 1].sequence + 1, out[i].sequence);
+                    }
+                }
+            }
+        });
+    }
+    for (uint64_t i = 0; i < 500'000; ++i) {
+        a.push_back({i, 2 * i, 3 * i});
+    }
+    done.store(true);
+    for (auto& reader: readers) {
+        reader.join();
+    }
+}
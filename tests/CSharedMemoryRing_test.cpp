@@ -0,0 +1,139 @@
+#include "lib/CSharedMemoryRing.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+
+namespace {
+    struct Event {
+        uint32_t producer;
+        uint32_t sequence;
+        uint64_t payload;
+    };
+
+    int wait_child(pid_t pid) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+}
+
+TEST(SharedMemoryRing, SingleProcessTest) {
+    auto ring = CSharedMemoryRing<Event>::create_anonymous(4);
+    Event e{};
+    EXPECT_FALSE(ring.try_pop(e));
+    for (uint32_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.try_push({0, i, i * 10}));
+    }
+    EXPECT_FALSE(ring.try_push({0, 4, 40}));
+    EXPECT_EQ(4, ring.size());
+    for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.try_pop(e));
+        EXPECT_EQ(i, e.sequence);
+        EXPECT_EQ(i * 10, e.payload);
+    }
+    EXPECT_FALSE(ring.pop_wait(e, std::chrono::milliseconds(1)));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SharedMemoryRing, OpenByNameTest) {
+    std::string name = "/cb_ring_test_" + std::to_string(getpid());
+    CSharedMemoryRing<Event>::unlink(name.c_str());
+    auto producer = CSharedMemoryRing<Event>::create(name.c_str(), 8);
+    EXPECT_THROW(CSharedMemoryRing<Event>::create(name.c_str(), 8), std::system_error);
+
+    auto consumer = CSharedMemoryRing<Event>::open(name.c_str());
+    EXPECT_EQ(8, consumer.capacity());
+    EXPECT_TRUE(producer.try_push({1, 2, 3}));
+    Event e{};
+    ASSERT_TRUE(consumer.try_pop(e));
+    EXPECT_EQ(3, e.payload);
+
+    EXPECT_THROW(CSharedMemoryRing<uint64_t>::open(name.c_str()), std::system_error);
+    CSharedMemoryRing<Event>::unlink(name.c_str());
+    EXPECT_THROW(CSharedMemoryRing<Event>::open(name.c_str()), std::system_error);
+}
+
+TEST(SharedMemoryRing, AttachRejectsBadGeometryTest) {
+    auto ring = CSharedMemoryRing<Event>::create_anonymous(8);
+    // Header fields: capacity at offset 16, slots_offset at 24, slot_size at 32.
+    auto field = [&](off_t offset) {
+        uint64_t value = 0;
+        EXPECT_EQ(ssize_t(sizeof(value)), pread(ring.fd(), &value, sizeof(value), offset));
+        return value;
+    };
+    auto set_field = [&](off_t offset, uint64_t value) {
+        EXPECT_EQ(ssize_t(sizeof(value)), pwrite(ring.fd(), &value, sizeof(value), offset));
+    };
+    auto rejected = [&](off_t offset, uint64_t value) {
+        uint64_t saved = field(offset);
+        set_field(offset, value);
+        bool thrown = false;
+        try {
+            CSharedMemoryRing<Event>::attach(dup(ring.fd()));
+        } catch (const std::system_error&) {
+            thrown = true;
+        }
+        set_field(offset, saved);
+        return thrown;
+    };
+
+    EXPECT_EQ(8, field(16));
+    EXPECT_TRUE(rejected(16, 0));
+    EXPECT_TRUE(rejected(16, 1000)); // slots past the end of the mapping
+    EXPECT_TRUE(rejected(24, 0));
+    EXPECT_TRUE(rejected(32, 1));
+    EXPECT_EQ(8, CSharedMemoryRing<Event>::attach(dup(ring.fd())).capacity());
+}
+
+TEST(SharedMemoryRing, ForkedProducerTest) {
+    constexpr uint32_t kmessages = 100'000;
+    auto ring = CSharedMemoryRing<Event>::create_anonymous(64);
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        for (uint32_t i = 0; i < kmessages; ++i) {
+            while (!ring.try_push({0, i, uint64_t(i) * i})) {
+                std::this_thread::yield();
+            }
+        }
+        _exit(0);
+    }
+
+    Event e{};
+    for (uint32_t i = 0; i < kmessages; ++i) {
+        ASSERT_TRUE(ring.pop_wait(e, std::chrono::seconds(10)));
+        ASSERT_EQ(i, e.sequence);
+        ASSERT_EQ(uint64_t(i) * i, e.payload);
+    }
+    EXPECT_EQ(0, wait_child(pid));
+}
+
+TEST(SharedMemoryRing, ForkedMultiProducerTest) {
+    constexpr uint32_t kproducers = 3;
+    constexpr uint32_t kmessages = 30'000;
+    auto ring = CSharedMemoryRing<Event, true>::create_anonymous(32);
+    pid_t pids[kproducers];
+    for (uint32_t p = 0; p < kproducers; ++p) {
+        pids[p] = fork();
+        ASSERT_GE(pids[p], 0);
+        if (pids[p] == 0) {
+            for (uint32_t i = 0; i < kmessages; ++i) {
+                while (!ring.try_push({p, i, 0})) {
+                    std::this_thread::yield();
+                }
+            }
+            _exit(0);
+        }
+    }
+
+    uint32_t next[kproducers] = {};
+    Event e{};
+    for (uint32_t n = 0; n < kproducers * kmessages; ++n) {
+        ASSERT_TRUE(ring.pop_wait(e, std::chrono::seconds(10)));
+        ASSERT_LT(e.producer, kproducers);
+        ASSERT_EQ(next[e.producer]++, e.sequence);
+    }
+    for (pid_t pid: pids) {
+        EXPECT_EQ(0, wait_child(pid));
+    }
+}
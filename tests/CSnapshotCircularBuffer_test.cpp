@@ -0,0 +1,73 @@
+#include "lib/CSnapshotCircularBuffer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(SnapshotCircularBuffer, SnapshotIsImmutableTest) {
+    CSnapshotCircularBuffer<int> a(10, 4);
+    for (int i = 0; i < 8; ++i) {
+        a.push_back(i);
+    }
+    auto snapshot = a.snapshot();
+    for (int i = 8; i < 30; ++i) {
+        a.push_back(i);
+    }
+    a.at(0) = -1;
+
+    std::vector<int> expected(8);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), snapshot.begin(), snapshot.end()));
+    EXPECT_EQ(10, a.size());
+    EXPECT_EQ(-1, a.front());
+    EXPECT_EQ(29, a.back());
+}
+
+TEST(SnapshotCircularBuffer, SeveralSnapshotsTest) {
+    CSnapshotCircularBuffer<std::string> a(5, 2);
+    a.push_back("a");
+    a.push_back("b");
+    auto first = a.snapshot();
+    a.push_back("c");
+    auto second = a.snapshot();
+    a.pop_front();
+    a.push_back("d");
+
+    EXPECT_EQ(2, first.size());
+    EXPECT_EQ("b", first.back());
+    EXPECT_EQ(3, second.size());
+    EXPECT_EQ("c", second.back());
+    EXPECT_EQ("b", a.front());
+    EXPECT_EQ("d", a.back());
+}
+
+TEST(SnapshotCircularBuffer, ZeroChunkSizeTest) {
+    EXPECT_THROW(CSnapshotCircularBuffer<int>(10, 0), std::invalid_argument);
+}
+
+TEST(SnapshotCircularBuffer, ConcurrentReaderTest) {
+    CSnapshotCircularBuffer<int> a(1000, 64);
+    std::mutex mutex;
+    std::atomic<bool> done{false};
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            CCircularBufferSnapshot<int> snapshot;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                snapshot = a.snapshot();
+            }
+            for (size_t i = 1; i < snapshot.size(); ++i) {
+                ASSERT_EQ(snapshot[i - 1] + 1, snapshot[i]);
+            }
+        }
+    });
+    for (int i = 0; i < 200'000; ++i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        a.push_back(i);
+    }
+    done.store(true);
+    reader.join();
+}
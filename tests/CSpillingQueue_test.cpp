@@ -0,0 +1,116 @@
+#include "lib/CSpillingQueue.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+namespace {
+    struct StringSerializer {
+        static void serialize(const std::string& value, std::vector<std::byte>& out) {
+            uint32_t length = static_cast<uint32_t>(value.size());
+            auto header = std::as_bytes(std::span<const uint32_t, 1>(&length, 1));
+            out.insert(out.end(), header.begin(), header.end());
+            auto bytes = std::as_bytes(std::span<const char>(value));
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+
+        static size_t deserialize(std::span<const std::byte> data, std::string& out) {
+            uint32_t length = 0;
+            if (data.size() < sizeof(length)) {
+                return 0;
+            }
+            std::memcpy(&length, data.data(), sizeof(length));
+            if (data.size() < sizeof(length) + length) {
+                return 0;
+            }
+            out.assign(reinterpret_cast<const char*>(data.data()) + sizeof(length), length);
+            return sizeof(length) + length;
+        }
+    };
+
+    size_t files_in(const std::string& directory) {
+        return static_cast<size_t>(std::distance(std::filesystem::directory_iterator(directory),
+                                                 std::filesystem::directory_iterator()));
+    }
+
+    std::string make_directory() {
+        std::string directory = testing::TempDir() + "spill_" + std::to_string(getpid());
+        std::filesystem::create_directories(directory);
+        return directory;
+    }
+}
+
+TEST(SpillingQueue, BoundedMemoryFifoTest) {
+    std::string directory = make_directory();
+    // 16 ints per ring, segments of 256 bytes.
+    CSpillingQueue<int> a(3 * 16 * sizeof(int), directory, 256);
+    EXPECT_TRUE(a.empty());
+    EXPECT_THROW(a.pop_front(), EmptyBufferException);
+
+    for (int i = 0; i < 10'000; ++i) {
+        a.push_back(i);
+        ASSERT_LE(a.in_memory(), 32);
+    }
+    EXPECT_EQ(10'000, a.size());
+    EXPECT_GT(a.spilled(), 9'000);
+    EXPECT_GT(a.segments(), 1);
+    EXPECT_EQ(0, files_in(directory));
+
+    int next_pop = 0;
+    int next_push = 10'000;
+    while (!a.empty()) {
+        ASSERT_EQ(next_pop, a.front());
+        a.pop_front();
+        ++next_pop;
+        if (next_pop % 3 == 0 && next_push < 15'000) {
+            a.push_back(next_push++);
+        }
+        ASSERT_LE(a.in_memory(), 32);
+    }
+    EXPECT_EQ(next_push, next_pop);
+    EXPECT_EQ(0, a.segments());
+    std::filesystem::remove_all(directory);
+}
+
+TEST(SpillingQueue, CustomSerializerTest) {
+    std::string directory = make_directory();
+    CSpillingQueue<std::string, StringSerializer> a(3 * 4 * sizeof(std::string), directory, 64);
+    for (int i = 0; i < 500; ++i) {
+        a.push_back(std::string(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26)));
+    }
+    EXPECT_GT(a.spilled(), 0);
+    std::string value;
+    for (int i = 0; i < 500; ++i) {
+        ASSERT_TRUE(a.try_pop_front(value));
+        ASSERT_EQ(std::string(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26)), value);
+    }
+    EXPECT_FALSE(a.try_pop_front(value));
+    std::filesystem::remove_all(directory);
+}
+
+TEST(SpillingQueue, MissingDirectoryTest) {
+    CSpillingQueue<int> a(3 * sizeof(int), "/nonexistent/spill");
+    a.push_back(1);
+    a.push_back(2);
+    EXPECT_THROW(a.push_back(3), std::system_error);
+}
+
+TEST(SpillingQueue, FullTailWithEmptyHeadStaysInMemoryTest) {
+    std::string directory = make_directory();
+    CSpillingQueue<int> a(3 * 4 * sizeof(int), directory);
+    for (int i = 0; i < 8; ++i) {
+        a.push_back(i);
+    }
+    for (int i = 0; i < 4; ++i) {
+        a.pop_front();
+    }
+    a.push_back(8);
+    EXPECT_EQ(0, a.spilled());
+    EXPECT_EQ(0, a.segments());
+    EXPECT_EQ(0, files_in(directory));
+    for (int i = 4; i <= 8; ++i) {
+        ASSERT_EQ(i, a.front());
+        a.pop_front();
+    }
+    EXPECT_TRUE(a.empty());
+    std::filesystem::remove_all(directory);
+}
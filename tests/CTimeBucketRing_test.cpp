@@ -0,0 +1,82 @@
+#include "lib/CTimeBucketRing.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Time = std::chrono::steady_clock::time_point;
+
+TEST(TimeBucketRing, SlidingWindowTest) {
+    Time start(1h);
+    CTimeBucketRing<uint32_t> a(10, 100ms, start);
+    EXPECT_EQ(1s, a.window());
+
+    a.add(start, 3);
+    a.add(start + 250ms);
+    a.add(start + 950ms, 2);
+    EXPECT_EQ(6, a.total(start + 950ms));
+    EXPECT_EQ(2, a.buckets().back());
+
+    EXPECT_EQ(3, a.total(start + 1s)); // bucket of start expired
+    EXPECT_EQ(2, a.total(start + 1250ms));
+    EXPECT_FALSE(a.add(start + 100ms)); // older than the window
+    EXPECT_TRUE(a.add(start + 1000ms));
+    EXPECT_EQ(3, a.total(start + 1250ms));
+
+    EXPECT_EQ(0, a.total(start + 1h)); // long gap clears at most size() buckets
+    EXPECT_EQ(10, a.buckets().size());
+    a.add(start + 1h, 5);
+    a.clear();
+    EXPECT_EQ(0, a.total(start + 1h));
+}
+
+TEST(TimeBucketRing, MatchesPerEventTimestampsTest) {
+    Time start(1h);
+    CTimeBucketRing<> a(60, 1s, start);
+    std::vector<Time> events;
+    for (int i = 0; i < 5000; ++i) {
+        Time t = start + std::chrono::milliseconds(i * 37 % 1000 + i * 50);
+        if (t < (events.empty() ? start : events.back())) {
+            continue;
+        }
+        a.add(t);
+        events.push_back(t);
+        auto first_bucket = (t.time_since_epoch() / 1s) - 59;
+        size_t expected = 0;
+        for (Time e: events) {
+            expected += e.time_since_epoch() / 1s >= first_bucket;
+        }
+        ASSERT_EQ(expected, a.total(t));
+    }
+}
+
+TEST(AtomicTimeBucketRing, ConcurrentAddTest) {
+    Time start(1h);
+    CAtomicTimeBucketRing<> a(10, 100ms);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                a.add(start + std::chrono::milliseconds(i % 10 * 100));
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(40000, a.total(start + 900ms));
+    EXPECT_EQ(36000, a.total(start + 1s));
+    EXPECT_FALSE(a.add(start + 1s - 1h)); // slot holds a newer bucket
+    EXPECT_TRUE(a.add(start + 1500ms));
+    EXPECT_EQ(4000 * 4 + 1, a.total(start + 1500ms));
+    EXPECT_EQ(0, a.total(start + 1h));
+}
+
+TEST(AtomicTimeBucketRing, StaleAddIgnoredTest) {
+    Time start(1h);
+    CAtomicTimeBucketRing<> a(10, 100ms);
+    EXPECT_TRUE(a.add(start - 10s)); // empty slot, no clock to compare with
+    EXPECT_EQ(0, a.total(start));
+    EXPECT_TRUE(a.add(start));
+    EXPECT_EQ(1, a.total(start));
+}
@@ -0,0 +1,64 @@
+#include "lib/CWindowedQuantile.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(WindowedQuantile, MatchesSortedWindowTest) {
+    CWindowedQuantile<int> a(100);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 2000; ++i) {
+        a.push(static_cast<int>(rng() % 50)); // many duplicates
+        std::vector<int> sorted(a.values().begin(), a.values().end());
+        std::sort(sorted.begin(), sorted.end());
+        ASSERT_EQ(std::min<size_t>(i + 1, 100), a.size());
+        for (double q: {0.0, 0.5, 0.95, 0.99, 1.0}) {
+            ASSERT_EQ(sorted[static_cast<size_t>(q * (sorted.size() - 1))], a.quantile(q));
+        }
+    }
+    for (size_t k = 0; k < a.size(); ++k) {
+        EXPECT_LE(a.select(k), a.select(std::min(k + 1, a.size() - 1)));
+    }
+}
+
+TEST(WindowedQuantile, PopAndClearTest) {
+    CWindowedQuantile<double, std::greater<>> a(3);
+    a.push(1.0);
+    a.push(3.0);
+    a.push(2.0);
+    EXPECT_EQ(3.0, a.select(0));
+    EXPECT_EQ(2.0, a.median());
+    a.pop_front();
+    EXPECT_EQ(2, a.size());
+    EXPECT_EQ(2.0, a.quantile(1.0));
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_THROW(a.pop_front(), EmptyBufferException);
+    a.push(5.0);
+    EXPECT_EQ(5.0, a.median());
+}
+
+TEST(WindowedQuantileSketch, RelativeErrorTest) {
+    CWindowedQuantileSketch<> a(1000);
+    EXPECT_EQ(0, a.quantile(0.5));
+    std::mt19937_64 rng(11);
+    for (int i = 0; i < 5000; ++i) {
+        a.push(rng() % 10'000'000);
+    }
+    std::vector<uint64_t> sorted(a.values().begin(), a.values().end());
+    std::sort(sorted.begin(), sorted.end());
+    for (double q: {0.0, 0.5, 0.95, 0.99, 1.0}) {
+        uint64_t exact = sorted[static_cast<size_t>(q * (sorted.size() - 1))];
+        uint64_t estimate = a.quantile(q);
+        EXPECT_GE(estimate, exact);
+        EXPECT_LE(estimate - exact, exact / 64 + 1);
+    }
+
+    CWindowedQuantileSketch<> small(4);
+    for (uint64_t v: {5, 100, 7, 3}) {
+        small.push(v);
+    }
+    EXPECT_EQ(3, small.quantile(0.0));
+    EXPECT_EQ(5, small.quantile(0.5));
+    EXPECT_EQ(100, small.quantile(1.0));
+}
@@ -0,0 +1,70 @@
+#include "lib/CWorkStealingDeque.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingDeque, OwnerAndThiefOrderTest) {
+    CWorkStealingDeque<int> a(4);
+    EXPECT_FALSE(a.pop().has_value());
+    EXPECT_FALSE(a.steal().has_value());
+
+    for (int i = 0; i < 10; ++i) {
+        a.push(i);
+    }
+    EXPECT_EQ(10, a.size());
+    EXPECT_EQ(16, a.capacity());
+
+    EXPECT_EQ(9, a.pop());
+    EXPECT_EQ(0, a.steal());
+    EXPECT_EQ(1, a.steal());
+    EXPECT_EQ(8, a.pop());
+    EXPECT_EQ(6, a.size());
+
+    a.push(42);
+    EXPECT_EQ(42, a.pop());
+    for (int i = 2; i < 8; ++i) {
+        EXPECT_EQ(i, a.steal());
+    }
+    EXPECT_TRUE(a.empty());
+    EXPECT_FALSE(a.pop().has_value());
+    EXPECT_FALSE(a.steal().has_value());
+}
+
+TEST(WorkStealingDeque, ConcurrentStealTest) {
+    constexpr int kitems = 200'000;
+    CWorkStealingDeque<int> a(2);
+    std::vector<std::atomic<int>> taken(kitems);
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            while (!done.load() || !a.empty()) {
+                if (auto item = a.steal()) {
+                    taken[*item].fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < kitems; ++i) {
+        a.push(i);
+        if (i % 3 == 0) {
+            if (auto item = a.pop()) {
+                taken[*item].fetch_add(1);
+            }
+        }
+    }
+    while (auto item = a.pop()) {
+        taken[*item].fetch_add(1);
+    }
+    done.store(true);
+    for (auto& thief: thieves) {
+        thief.join();
+    }
+
+    for (int i = 0; i < kitems; ++i) {
+        ASSERT_EQ(1, taken[i].load()) << i;
+    }
+}